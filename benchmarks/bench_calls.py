@@ -0,0 +1,36 @@
+# -*- coding: utf-8 -*-
+
+# Call overhead of the constructor and of the methods on tiny ProcSets, where the work done
+# is negligible next to the argument passing. The operator `p | q` is given as a reference.
+# Run with: python3 benchmarks/bench_calls.py
+
+import timeit
+from procset import ProcSet, FrozenProcSet
+
+NUMBER = 200_000
+
+
+def main():
+    p, q = ProcSet((0, 3), 7), ProcSet((2, 5))
+    itv = (1, 5)
+    cases = {
+        'ProcSet()': lambda: ProcSet(),
+        'ProcSet(5)': lambda: ProcSet(5),
+        'ProcSet((1, 5))': lambda: ProcSet(itv),
+        'ProcSet(q)': lambda: ProcSet(q),
+        'ProcSet(1, 3, 5)': lambda: ProcSet(1, 3, 5),
+        'FrozenProcSet(5)': lambda: FrozenProcSet(5),
+        'p.union(q)': lambda: p.union(q),
+        'p.union(3)': lambda: p.union(3),
+        'p.update(q)': lambda: p.update(q),
+        'p.issubset(q)': lambda: p.issubset(q),
+        'p.intervals_list()': lambda: p.intervals_list(),
+        'p | q': lambda: p | q,
+    }
+    for name, func in cases.items():
+        best = min(timeit.repeat(func, number=NUMBER, repeat=5)) / NUMBER
+        print('{:>20}: {:8.1f} ns / call'.format(name, best * 1e9))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,33 @@
+# -*- coding: utf-8 -*-
+
+# Equality of large ProcSets: equal, rejected by the fingerprint, and differing only in the middle.
+# Run with: python3 benchmarks/bench_eq.py
+
+import timeit
+from procset import ProcSet
+
+NUMBER = 1000
+
+
+def main():
+    for nb_intervals in (10, 1000, 100_000):
+        itvs = [(i * 4, i * 4 + 1) for i in range(nb_intervals)]
+        base = ProcSet(*itvs)
+        equal = ProcSet(*itvs)
+        other_size = ProcSet(*itvs, nb_intervals * 4 + 10)
+        middle = itvs[:]
+        lo, hi = middle[nb_intervals // 2]
+        middle[nb_intervals // 2] = (lo + 1, hi + 1)
+        same_fingerprint = ProcSet(*middle)
+        cases = {
+            'equal': lambda: base == equal,
+            'different size': lambda: base == other_size,
+            'middle differs': lambda: base == same_fingerprint,
+        }
+        for name, func in cases.items():
+            best = min(timeit.repeat(func, number=NUMBER, repeat=5)) / NUMBER
+            print('{:>7} intervals {:>15}: {:10.1f} ns'.format(nb_intervals, name, best * 1e9))
+
+
+if __name__ == '__main__':
+    main()
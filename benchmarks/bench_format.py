@@ -0,0 +1,28 @@
+# -*- coding: utf-8 -*-
+
+# Rendering throughput of str(), repr() and format() on ProcSets with many intervals.
+# Run with: python3 benchmarks/bench_format.py
+
+import timeit
+from procset import ProcSet
+
+NUMBER = 20
+
+
+def main():
+    for nb_intervals in (1, 100, 100_000):
+        pset = ProcSet(*((i * 4, i * 4 + (i % 3)) for i in range(nb_intervals)))
+        cases = {
+            'str': lambda: str(pset),
+            'repr': lambda: repr(pset),
+            'format ascii': lambda: format(pset, ':,'),
+            'format utf-8': lambda: format(pset, '→·'),
+        }
+        for name, func in cases.items():
+            best = min(timeit.repeat(func, number=NUMBER, repeat=5)) / NUMBER
+            print('{:>7} intervals {:>12}: {:10.2f} us ({:6.1f} ns / interval)'.format(
+                nb_intervals, name, best * 1e6, best * 1e9 / nb_intervals))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,44 @@
+# -*- coding: utf-8 -*-
+
+# Throughput of short-lived procsets, created by the operators and dropped at once, and the hit rate
+# of the free list of dead procsets they go through.
+# Run with: python3 benchmarks/bench_freelist.py
+
+import timeit
+import procset
+from procset import ProcSet, FrozenProcSet
+
+NUMBER = 200_000
+
+
+def main():
+    one, two = ProcSet(1), ProcSet((5, 9))
+    left = ProcSet(*((i, i + 2) for i in range(0, 400, 8)))
+    right = ProcSet(*((i, i + 2) for i in range(4, 400, 8)))
+    frozen = FrozenProcSet(left)
+    cases = {
+        'p | q (2 itvs)': lambda: one | two,
+        'p & q (50 itvs)': lambda: left & right,
+        'p | q (50 itvs)': lambda: left | right,
+        'p.copy() (50 itvs)': lambda: left.copy(),
+        'f - p (frozen)': lambda: frozen - right,
+        'p <= q': lambda: one <= two,
+    }
+    for name, func in cases.items():
+        has_stats = hasattr(procset, '_alloc_stats')
+        before = procset._alloc_stats() if has_stats else None
+        best = min(timeit.repeat(func, number=NUMBER, repeat=5)) / NUMBER
+        line = '{:>20}: {:8.1f} ns / call'.format(name, best * 1e9)
+        if has_stats:
+            after = procset._alloc_stats()
+            allocations = after['allocations'] - before['allocations']
+            objects = after['reused_objects'] - before['reused_objects']
+            buffers = after['reused_buffers'] - before['reused_buffers']
+            if allocations:
+                line += ', {:6.1%} objects reused, {:6.1%} buffers reused'.format(
+                    objects / allocations, buffers / allocations)
+        print(line)
+
+
+if __name__ == '__main__':
+    main()
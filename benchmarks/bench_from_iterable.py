@@ -0,0 +1,34 @@
+# -*- coding: utf-8 -*-
+
+# Building a ProcSet from many processor indexes: constructor arguments vs from_iterable.
+# Run with: python3 benchmarks/bench_from_iterable.py
+
+import array
+import random
+import timeit
+from procset import ProcSet
+
+NUMBER = 20
+
+
+def main():
+    random.seed(0)
+    for size in (100, 50_000):
+        node_ids = sorted(random.sample(range(size * 4), size))
+        shuffled = random.sample(node_ids, size)
+        buffer = array.array('I', shuffled)
+        cases = {
+            'ProcSet(*ids)': lambda: ProcSet(*node_ids),
+            'from_iterable(ids)': lambda: ProcSet.from_iterable(node_ids),
+            'from_iterable(shuffled)': lambda: ProcSet.from_iterable(shuffled),
+            'from_iterable(array)': lambda: ProcSet.from_iterable(buffer),
+            'from_iterable(range)': lambda: ProcSet.from_iterable(range(size)),
+        }
+        for name, func in cases.items():
+            best = min(timeit.repeat(func, number=NUMBER, repeat=5)) / NUMBER
+            print('{:>6} ids {:>24}: {:10.2f} us ({:6.1f} ns / id)'.format(
+                size, name, best * 1e6, best * 1e9 / size))
+
+
+if __name__ == '__main__':
+    main()
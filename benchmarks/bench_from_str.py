@@ -0,0 +1,57 @@
+# -*- coding: utf-8 -*-
+
+# Parsing throughput of ProcSet.from_str on batch-scheduler-like resource strings, and the allocations
+# made to parse 100k tokens, by the fast parser and by the generic one ('_' in the numbers).
+# Run with: python3 benchmarks/bench_from_str.py
+
+import random
+import time
+import timeit
+import tracemalloc
+import procset
+from procset import ProcSet
+
+NUMBER = 200
+NB_TOKENS = 100_000
+
+
+def resource_string(nb_intervals, shuffle=False):
+    itvs = ['{}-{}'.format(i * 2048, i * 2048 + 1023) for i in range(nb_intervals)]
+    if shuffle:
+        random.shuffle(itvs)
+    return ' '.join(itvs)
+
+
+def underscored_string(nb_intervals):
+    return ' '.join('{:_}-{:_}'.format(i * 2048, i * 2048 + 1023) for i in range(nb_intervals))
+
+
+def allocations(name, string):
+    has_stats = hasattr(procset, '_alloc_stats')
+    before = procset._alloc_stats()['allocations'] if has_stats else 0
+    tracemalloc.start()
+    start = time.perf_counter()
+    ProcSet.from_str(string)
+    elapsed = time.perf_counter() - start
+    _, peak = tracemalloc.get_traced_memory()
+    tracemalloc.stop()
+    procsets = procset._alloc_stats()['allocations'] - before if has_stats else 'n/a'
+    print('{:>24}: {:>7} procsets allocated, {:8.1f} KiB peak, {:8.2f} ms'.format(
+        name, procsets, peak / 1024, elapsed * 1e3))
+
+
+def main():
+    random.seed(0)
+    for nb_intervals in (1, 16, 256, 4096):
+        for shuffle in (False, True):
+            string = resource_string(nb_intervals, shuffle)
+            best = min(timeit.repeat(lambda: ProcSet.from_str(string), number=NUMBER, repeat=5)) / NUMBER
+            print('{:>5} intervals{:>10}: {:10.2f} us / parse ({:6.1f} ns / interval)'.format(
+                nb_intervals, ' shuffled' if shuffle else '', best * 1e6, best * 1e9 / nb_intervals))
+
+    allocations('{} tokens'.format(NB_TOKENS), resource_string(NB_TOKENS))
+    allocations('{} tokens, generic'.format(NB_TOKENS), underscored_string(NB_TOKENS))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,31 @@
+# -*- coding: utf-8 -*-
+
+# Hashing FrozenProcSets and using them as dict keys.
+# Run with: python3 benchmarks/bench_frozen.py
+
+import timeit
+from procset import FrozenProcSet
+
+NUMBER = 1000
+
+
+def main():
+    for nb_intervals in (1, 100, 100_000):
+        cached = FrozenProcSet(*((i * 4, i * 4 + 1) for i in range(nb_intervals)))
+        cache = {cached: None}
+        number = NUMBER if nb_intervals < 100_000 else 20
+        cases = {
+            'first hash': lambda: [hash(f) for f in fresh],
+            'cached hash': lambda: [hash(cached) for _ in range(number)],
+            'dict lookup': lambda: [cached in cache for _ in range(number)],
+        }
+        for name, func in cases.items():
+            best = float('inf')
+            for _ in range(5):
+                fresh = [FrozenProcSet.from_boundaries(cached) for _ in range(number)]
+                best = min(best, timeit.timeit(func, number=1) / number)
+            print('{:>7} intervals {:>12}: {:12.1f} ns'.format(nb_intervals, name, best * 1e9))
+
+
+if __name__ == '__main__':
+    main()
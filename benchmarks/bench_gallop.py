@@ -0,0 +1,46 @@
+# -*- coding: utf-8 -*-
+
+# Compares the galloping merge with the linear sweep (gallop ratio 0) on operands of
+# increasingly different sizes. Run with: python3 benchmarks/bench_gallop.py
+
+import random
+import timeit
+import procset
+from procset import ProcSet
+
+BIG = 100_000                   # number of intervals of the big operand
+RATIOS = (1, 4, 16, 64, 256, 1024, 8192, 33_333)
+OPERATIONS = ('__or__', '__and__', '__sub__', '__xor__')
+
+
+def make_pset(nb_itv, span, rng):
+    # nb_itv intervals spread over [0, span[
+    starts = sorted(rng.sample(range(0, span, 4), nb_itv))
+    return ProcSet(*((s, s + rng.randint(0, 2)) for s in starts))
+
+
+def bench(left, right, operation, ratio):
+    previous = procset.set_gallop_ratio(ratio)
+    func = getattr(left, operation)
+    number = 20
+    best = min(timeit.repeat(lambda: func(right), number=number, repeat=5)) / number
+    procset.set_gallop_ratio(previous)
+    return best
+
+
+def main():
+    rng = random.Random(42)
+    pool = make_pset(BIG, 8 * BIG, rng)
+
+    print('{:>8} {:>10} {:>12} {:>12} {:>8}'.format('ratio', 'operation', 'linear (us)', 'gallop (us)', 'speedup'))
+    for ratio in RATIOS:
+        request = make_pset(max(1, BIG // ratio), 8 * BIG, rng)
+        for operation in OPERATIONS:
+            linear = bench(request, pool, operation, 0)
+            gallop = bench(request, pool, operation, 8)
+            print('{:>8} {:>10} {:>12.1f} {:>12.1f} {:>7.1f}x'.format(
+                ratio, operation, linear * 1e6, gallop * 1e6, linear / gallop))
+
+
+if __name__ == '__main__':
+    main()
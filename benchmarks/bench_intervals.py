@@ -0,0 +1,28 @@
+# -*- coding: utf-8 -*-
+
+# Iteration over the intervals of large ProcSets.
+# Run with: python3 benchmarks/bench_intervals.py
+
+import timeit
+from procset import ProcSet
+
+NUMBER = 20
+
+
+def main():
+    for nb_intervals in (100, 100_000):
+        pset = ProcSet(*((i * 4, i * 4 + 1) for i in range(nb_intervals)))
+        cases = {
+            'for itv in intervals()': lambda: [None for _ in pset.intervals()],
+            'list(intervals())': lambda: list(pset.intervals()),
+            'intervals_list()': lambda: pset.intervals_list(),
+            'chunks of 1000': lambda: [pset.intervals_list(i, i + 1000) for i in range(0, nb_intervals, 1000)],
+        }
+        for name, func in cases.items():
+            best = min(timeit.repeat(func, number=NUMBER, repeat=5)) / NUMBER
+            print('{:>7} intervals {:>24}: {:10.2f} us ({:6.1f} ns / interval)'.format(
+                nb_intervals, name, best * 1e6, best * 1e9 / nb_intervals))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,27 @@
+# -*- coding: utf-8 -*-
+
+# Expanding a ProcSet to its individual processors.
+# Run with: python3 benchmarks/bench_iter.py
+
+import timeit
+from procset import ProcSet
+
+NUMBER = 10
+
+
+def main():
+    for nb_intervals in (1, 1000, 10_000):
+        pset = ProcSet(*((i * 64, i * 64 + 31) for i in range(nb_intervals)))
+        cases = {
+            'list(pset)': lambda: list(pset),
+            'list(reversed(pset))': lambda: list(reversed(pset)),
+            'for p in pset': lambda: [None for _ in pset],
+        }
+        for name, func in cases.items():
+            best = min(timeit.repeat(func, number=NUMBER, repeat=5)) / NUMBER
+            print('{:>6} intervals {:>22}: {:10.2f} us ({:5.1f} ns / processor)'.format(
+                nb_intervals, name, best * 1e6, best * 1e9 / len(pset)))
+
+
+if __name__ == '__main__':
+    main()
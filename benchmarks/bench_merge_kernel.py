@@ -0,0 +1,58 @@
+# -*- coding: utf-8 -*-
+
+# Cost per boundary of the merge kernel of each operation, without the allocation of the result
+# nor the Python call around it. Galloping is disabled, so every boundary goes through the inner loop.
+# Run with: python3 benchmarks/bench_merge_kernel.py [cpu frequency in GHz, to get cycles]
+
+import random
+import sys
+import time
+import procset
+from procset import ProcSet
+
+NB_ITV = 100_000
+REPEAT = 50
+OPERATIONS = ('union', 'intersection', 'difference', 'symmetric_difference')
+
+
+def make_pset(nb_itv, span, rng):
+    # nb_itv intervals spread over [0, span[
+    starts = sorted(rng.sample(range(0, span, 4), nb_itv))
+    return ProcSet(*((s, s + rng.randint(0, 2)) for s in starts))
+
+
+def bench(operation, left, right):
+    nb_boundary = 2 * (left.count() + right.count())
+    best = float('inf')
+    for _ in range(5):
+        start = time.perf_counter_ns()
+        procset._run_merge_kernel(operation, left, right, REPEAT)
+        best = min(best, time.perf_counter_ns() - start)
+    return best / REPEAT / nb_boundary
+
+
+def main():
+    ghz = float(sys.argv[1]) if len(sys.argv) > 1 else None
+    rng = random.Random(42)
+    cases = {
+        # the operands alternate randomly: whether a boundary is kept cannot be predicted
+        'interleaved': (make_pset(NB_ITV, 8 * NB_ITV, rng), make_pset(NB_ITV, 8 * NB_ITV, rng)),
+        # all the boundaries of the left operand come first
+        'disjoint': (make_pset(NB_ITV, 8 * NB_ITV, rng),
+                     ProcSet(*((8 * NB_ITV + s, 8 * NB_ITV + s + 1) for s in range(0, 4 * NB_ITV, 4)))),
+    }
+
+    previous = procset.set_gallop_ratio(0)
+    print('{:>12} {:>22} {:>14}'.format('operands', 'operation', 'ns/boundary') + (' {:>16}'.format('cycles/boundary') if ghz else ''))
+    for case, (left, right) in cases.items():
+        for operation in OPERATIONS:
+            cost = bench(operation, left, right)
+            line = '{:>12} {:>22} {:>14.2f}'.format(case, operation, cost)
+            if ghz:
+                line += ' {:>16.1f}'.format(cost * ghz)
+            print(line)
+    procset.set_gallop_ratio(previous)
+
+
+if __name__ == '__main__':
+    main()
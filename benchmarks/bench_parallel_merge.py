@@ -0,0 +1,45 @@
+# -*- coding: utf-8 -*-
+
+# Parallel merges of big procsets, for an increasing number of merge threads (see set_merge_threads).
+# Run with: python3 benchmarks/bench_parallel_merge.py
+
+import os
+import random
+import timeit
+import procset
+from procset import ProcSet
+
+SIZES = (100_000, 1_000_000, 4_000_000)         # number of intervals of each operand
+OPERATIONS = ('__or__', '__and__', '__sub__', '__xor__')
+
+
+def make_pset(nb_itv, span, rng):
+    # nb_itv intervals spread over [0, span[
+    starts = sorted(rng.sample(range(0, span, 4), nb_itv))
+    return ProcSet(*((s, s + rng.randint(0, 2)) for s in starts))
+
+
+def main():
+    rng = random.Random(42)
+    nb_cores = os.cpu_count() or 1
+    all_threads = sorted({1, 2, 4, 8, nb_cores})
+    print('{} cores'.format(nb_cores))
+    print('{:>10} {:>10} '.format('intervals', 'operation')
+          + ' '.join('{:>12}'.format('{} thr (ms)'.format(threads)) for threads in all_threads))
+
+    previous = procset.set_merge_threads(1)
+    for size in SIZES:
+        left, right = make_pset(size, 8 * size, rng), make_pset(size, 8 * size, rng)
+        for operation in OPERATIONS:
+            func = getattr(left, operation)
+            times = []
+            for threads in all_threads:
+                procset.set_merge_threads(threads)
+                times.append(min(timeit.repeat(lambda: func(right), number=3, repeat=3)) / 3)
+            print('{:>10} {:>10} '.format(size, operation)
+                  + ' '.join('{:>12.2f}'.format(t * 1e3) for t in times))
+    procset.set_merge_threads(previous)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,33 @@
+# -*- coding: utf-8 -*-
+
+# Serialization of ProcSets: binary encoding and pickle against the string round trip.
+# Run with: python3 benchmarks/bench_pickle.py
+
+import pickle
+import timeit
+from procset import ProcSet
+
+NUMBER = 50
+
+
+def main():
+    for nb_intervals in (1, 100, 100_000):
+        pset = ProcSet(*((i * 2048, i * 2048 + 1023) for i in range(nb_intervals)))
+        data, text, pickled = pset.to_bytes(), str(pset), pickle.dumps(pset, pickle.HIGHEST_PROTOCOL)
+        cases = {
+            'to_bytes': lambda: pset.to_bytes(),
+            'from_bytes': lambda: ProcSet.from_bytes(data),
+            'pickle.dumps': lambda: pickle.dumps(pset, pickle.HIGHEST_PROTOCOL),
+            'pickle.loads': lambda: pickle.loads(pickled),
+            'str': lambda: str(pset),
+            'from_str': lambda: ProcSet.from_str(text),
+        }
+        print('{} intervals: {} bytes encoded, {} bytes pickled, {} characters as a string'.format(
+            nb_intervals, len(data), len(pickled), len(text)))
+        for name, func in cases.items():
+            best = min(timeit.repeat(func, number=NUMBER, repeat=5)) / NUMBER
+            print('{:>14}: {:10.2f} us'.format(name, best * 1e6))
+
+
+if __name__ == '__main__':
+    main()
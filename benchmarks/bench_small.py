@@ -0,0 +1,38 @@
+# -*- coding: utf-8 -*-
+
+# Creation throughput and memory footprint of small ProcSets (1 or 2 intervals).
+# Run with: python3 benchmarks/bench_small.py
+
+import resource
+import timeit
+from procset import ProcSet
+
+NUMBER = 1_000_000
+
+
+def rss_kib():
+    return resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+
+
+def main():
+    one, two = ProcSet(1), ProcSet((5, 9))
+    cases = {
+        'ProcSet(int)': lambda: ProcSet(3),
+        'ProcSet((a, b))': lambda: ProcSet((3, 7)),
+        'p | q (2 itvs)': lambda: one | two,
+        'p.aggregate()': lambda: two.aggregate(),
+        'p.copy()': lambda: two.copy(),
+    }
+    for name, func in cases.items():
+        best = min(timeit.repeat(func, number=NUMBER // 10, repeat=5)) / (NUMBER // 10)
+        print('{:>16}: {:8.1f} ns / object'.format(name, best * 1e9))
+
+    before = rss_kib()
+    kept = [ProcSet(i, i + 2) for i in range(NUMBER)]
+    after = rss_kib()
+    print('{:>16}: {:8.1f} bytes / object ({} objects kept alive)'.format(
+        'RSS', (after - before) * 1024 / len(kept), len(kept)))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,52 @@
+# -*- coding: utf-8 -*-
+
+# Throughput of big set operations run by several threads at once. The merges release the GIL,
+# so the throughput scales with the number of cores.
+# Run with: python3 benchmarks/bench_threads.py
+
+import os
+import random
+import threading
+import time
+from procset import ProcSet
+
+NB_ITV = 200_000
+OPERATIONS_PER_THREAD = 40
+
+
+def make_pset(nb_itv, span, rng):
+    # nb_itv intervals spread over [0, span[
+    starts = sorted(rng.sample(range(0, span, 4), nb_itv))
+    return ProcSet(*((s, s + rng.randint(0, 2)) for s in starts))
+
+
+def run(nb_threads, left, right):
+    def work():
+        for _ in range(OPERATIONS_PER_THREAD):
+            left | right        # pylint: disable=pointless-statement
+
+    threads = [threading.Thread(target=work) for _ in range(nb_threads)]
+    start = time.perf_counter()
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    return nb_threads * OPERATIONS_PER_THREAD / (time.perf_counter() - start)
+
+
+def main():
+    rng = random.Random(42)
+    left, right = make_pset(NB_ITV, 8 * NB_ITV, rng), make_pset(NB_ITV, 8 * NB_ITV, rng)
+
+    nb_cores = os.cpu_count() or 1
+    print('{} cores'.format(nb_cores))
+    print('{:>8} {:>12} {:>8}'.format('threads', 'unions/s', 'speedup'))
+    single = None
+    for nb_threads in sorted({1, 2, 4, 8, nb_cores}):
+        throughput = run(nb_threads, left, right)
+        single = single or throughput
+        print('{:>8} {:>12.1f} {:>7.2f}x'.format(nb_threads, throughput, throughput / single))
+
+
+if __name__ == '__main__':
+    main()
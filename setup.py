@@ -7,7 +7,8 @@ setup(
         Extension(
             name="procset",
             sources=["src/procsetmodule.c"],
-            extra_compile_args=["-g", "-Wall", "-Wextra", "-Werror", "-std=c99"],
+            extra_compile_args=["-g", "-Wall", "-Wextra", "-Werror", "-std=c99", "-pthread"],
+            extra_link_args=["-pthread"],
         )
     ],
     author="Elisée Chemin",
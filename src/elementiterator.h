@@ -0,0 +1,134 @@
+#ifndef __PROCSET_ELEMENTITER_H_
+#define __PROCSET_ELEMENTITER_H_
+
+#include <Python.h>
+#include "procsetheader.h"
+
+static PyTypeObject ElementIterType;
+
+// iterates over the processors of a procset, interval by interval, in increasing or decreasing order
+typedef struct {
+    PyObject_HEAD           // python object boilerplate
+    Py_ssize_t i;           // the index of the lower bound of the current interval
+    pset_boundary_t next;   // the next processor returned, or the (exclusive) upper bound when reversed
+    bool reversed;
+    Py_ssize_t left;        // the number of processors left, for __length_hint__
+    ProcSetObject * obj;    // NULL once the iteration is over
+} ElementIterator;
+
+static PyObject *
+ElementIterator_new(ProcSetObject * pset, bool reversed){
+    ElementIterator * iter = PyObject_GC_New(ElementIterator, &ElementIterType);
+    if (!iter){
+        return NULL;
+    }
+
+    iter->reversed = reversed;
+    iter->i = reversed ? pset->nb_boundary - 2 : 0;
+    iter->next = reversed ? MAX_BOUND_VALUE : 0;
+    iter->left = pset->length;
+    iter->obj = (ProcSetObject *) Py_NewRef(pset);
+
+    PyObject_GC_Track(iter);
+    return (PyObject *) iter;
+}
+
+static PyObject *
+_element_iterator_stop(ElementIterator * self){
+    Py_CLEAR(self->obj);
+    self->left = 0;
+    return NULL;
+}
+
+static PyObject *
+ElementIterator_next(ElementIterator * self){
+    ProcSetObject * pset = self->obj;
+    if (!pset){
+        return NULL;
+    }
+
+    // the boundaries are read again at every step, the procset may have been modified
+    const pset_boundary_t * bounds = pset->_boundaries;
+    Py_ssize_t nb = pset->nb_boundary;
+    pset_boundary_t value;
+
+    if (!self->reversed){
+        if (self->i + 1 >= nb){
+            return _element_iterator_stop(self);
+        }
+        if (self->next < bounds[self->i]){
+            self->next = bounds[self->i];
+        }
+        // current interval exhausted, on to the next one
+        if (self->next >= bounds[self->i + 1]){
+            self->i += 2;
+            if (self->i + 1 >= nb){
+                return _element_iterator_stop(self);
+            }
+            self->next = bounds[self->i];
+        }
+        value = self->next++;
+    } else {
+        if (self->i + 1 >= nb){
+            // the procset shrank
+            self->i = nb - 2;
+        }
+        if (self->i < 0){
+            return _element_iterator_stop(self);
+        }
+        if (self->next > bounds[self->i + 1]){
+            self->next = bounds[self->i + 1];
+        }
+        if (self->next <= bounds[self->i]){
+            self->i -= 2;
+            if (self->i < 0){
+                return _element_iterator_stop(self);
+            }
+            self->next = bounds[self->i + 1];
+        }
+        value = --self->next;
+    }
+
+    if (self->left > 0){
+        self->left--;
+    }
+    return PyLong_FromUnsignedLong(value);
+}
+
+// __length_hint__: the number of processors left, exact unless the procset is modified
+static PyObject *
+ElementIterator_lengthHint(ElementIterator * self, PyObject * Py_UNUSED(args)){
+    return PyLong_FromSsize_t(self->obj ? self->left : 0);
+}
+
+static int
+ElementIterator_traverse(ElementIterator * self, visitproc visit, void * arg){
+    Py_VISIT(self->obj);
+    return 0;
+}
+
+static void
+ElementIterator_dealloc(ElementIterator * self){
+    PyObject_GC_UnTrack(self);
+    Py_XDECREF(self->obj);
+    PyObject_GC_Del(self);
+}
+
+static PyMethodDef ElementIterator_methods[] = {
+    {"__length_hint__", (PyCFunction) ElementIterator_lengthHint, METH_NOARGS, "Private method returning an estimate of len(list(it))."},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyTypeObject ElementIterType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "element_iterator",
+    .tp_basicsize = sizeof(ElementIterator),
+    .tp_dealloc = (destructor) ElementIterator_dealloc,
+    .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,
+    .tp_traverse = (traverseproc) ElementIterator_traverse,
+    .tp_iter = PyObject_SelfIter,
+    .tp_iternext = (iternextfunc) ElementIterator_next,
+    .tp_methods = ElementIterator_methods,
+};
+
+#endif
@@ -9,121 +9,128 @@ static PyTypeObject IntervalIterType;
 typedef struct {
     PyObject_HEAD           // python object boilerplate
     Py_ssize_t i;           // la position actuelle
-    Py_ssize_t max;         // position max
-    ProcSetObject * obj;
+    ProcSetObject * obj;    // NULL once the iteration is over
+    PyObject * result;      // the last tuple returned, reused if nobody else holds it
 } IntervalIterator;
 
+// the (a, b) tuple of the closed interval [a, b], small values come from the small int cache
+static inline PyObject *
+_interval_tuple(pset_boundary_t a, pset_boundary_t b){
+    PyObject * lower = PyLong_FromUnsignedLong(a);
+    PyObject * upper = PyLong_FromUnsignedLong(b);
+    PyObject * tuple = (lower && upper) ? PyTuple_Pack(2, lower, upper) : NULL;
+    Py_XDECREF(lower);
+    Py_XDECREF(upper);
+    return tuple;
+}
+
 static PyObject *
 IntervalIterator_new (ProcSetObject* self){
     #ifdef PSET_DEBUG
     printf("(IntervalIterator) New iterator object @%p\n", (void *) self);
     #endif
     // a new iterator
-    IntervalIterator * iter = (IntervalIterator *) IntervalIterType.tp_alloc(&IntervalIterType, 0);
+    IntervalIterator * iter = PyObject_GC_New(IntervalIterator, &IntervalIterType);
     if (!iter){
         return NULL;
     }
 
     // we set the values for the iterator
     iter->i = 0;
-    iter->max = self->nb_boundary;
-    
-    Py_INCREF(self);
-    iter->obj = self;
+    iter->obj = (ProcSetObject *) Py_NewRef(self);
+    iter->result = NULL;
 
+    PyObject_GC_Track(iter);
     return (PyObject *) iter;
 }
 
-static PyObject *
-IntervalIterator_iter(PyObject * self){
-    Py_IncRef(self);
-    #ifdef PSET_DEBUG
-    printf("(IntervalIterator) iterator @%p is held by %li refs\n", (void *) self, Py_REFCNT(self));
-    #endif
-    return self;
-}
-
 static PyObject *
 IntervalIterator_next(IntervalIterator* self){
-    // if self is null;
-    if (!self || !self->obj){
-        //TODO: REAL ERROR MESSAGE
+    ProcSetObject * pset = self->obj;
+    if (!pset){
         return NULL;
-    } 
-    
-    // early termination if the iteration is over
-    else if (self->i >= self->max){
-        Py_DECREF(self->obj);   // the iterator holds a strong reference so we have to decref
+    }
+
+    // the procset may have been modified since the last step, its size is read every time
+    if (self->i + 1 >= pset->nb_boundary){
         self->obj = NULL;
+        Py_DECREF(pset);   // the iterator holds a strong reference so we have to decref
         return NULL;
     }
 
     // to make it easier to read
-    pset_boundary_t a = self->obj->_boundaries[self->i];
-    pset_boundary_t b = self->obj->_boundaries[self->i+1] -1 ;
-
-    // we set the values
-    PyObject * tuple = PyTuple_New(2);
-    PyTuple_SetItem(tuple, 0, PyLong_FromDouble(a));
-    PyTuple_SetItem(tuple, 1, PyLong_FromDouble(b));
+    pset_boundary_t a = pset->_boundaries[self->i];
+    pset_boundary_t b = pset->_boundaries[self->i+1] - 1;
+    self->i += 2;        // the next interval
+
+    // the previous tuple is only held by us: it is refilled instead of allocating a new one
+    PyObject * tuple = self->result;
+    if (tuple && Py_REFCNT(tuple) == 1){
+        PyObject * lower = PyLong_FromUnsignedLong(a);
+        PyObject * upper = PyLong_FromUnsignedLong(b);
+        if (!lower || !upper){
+            Py_XDECREF(lower);
+            Py_XDECREF(upper);
+            return NULL;
+        }
+
+        PyObject * old_lower = PyTuple_GET_ITEM(tuple, 0);
+        PyObject * old_upper = PyTuple_GET_ITEM(tuple, 1);
+        PyTuple_SET_ITEM(tuple, 0, lower);
+        PyTuple_SET_ITEM(tuple, 1, upper);
+        Py_DECREF(old_lower);
+        Py_DECREF(old_upper);
+        return Py_NewRef(tuple);
+    }
 
-    self->i +=2;        // on avance
+    tuple = _interval_tuple(a, b);
+    if (tuple){
+        Py_XSETREF(self->result, Py_NewRef(tuple));
+    }
     return tuple;
 }
 
+// __length_hint__: the number of intervals left
+static PyObject *
+IntervalIterator_lengthHint(IntervalIterator * self, PyObject * Py_UNUSED(args)){
+    Py_ssize_t left = self->obj ? (self->obj->nb_boundary - self->i) / 2 : 0;
+    return PyLong_FromSsize_t(left > 0 ? left : 0);
+}
+
+static int
+IntervalIterator_traverse(IntervalIterator * self, visitproc visit, void * arg){
+    Py_VISIT(self->obj);
+    Py_VISIT(self->result);
+    return 0;
+}
+
 static void
 IntervalIterator_dealloc(IntervalIterator * self){
     #ifdef PSET_DEBUG
     printf("(IntervalIterator) Calling dealloc on iterator object @%p\n", (void *) self);
     #endif
 
+    PyObject_GC_UnTrack(self);
     Py_XDECREF(self->obj);
-    IntervalIterType.tp_free((PyObject *) self);
+    Py_XDECREF(self->result);
+    PyObject_GC_Del(self);
 }
 
+static PyMethodDef IntervalIterator_methods[] = {
+    {"__length_hint__", (PyCFunction) IntervalIterator_lengthHint, METH_NOARGS, "Private method returning an estimate of len(list(it))."},
+    {NULL, NULL, 0, NULL}
+};
+
 static PyTypeObject IntervalIterType = {
     PyVarObject_HEAD_INIT(NULL, 0)
     .tp_name = "interval_iterator",
     .tp_basicsize = sizeof(IntervalIterator),
     .tp_dealloc = (destructor) IntervalIterator_dealloc,
-    .tp_flags = Py_TPFLAGS_DEFAULT /* | Py_TPFLAGS_HAVE_GC */,
-    .tp_iter = (getiterfunc) IntervalIterator_iter,
+    .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,
+    .tp_traverse = (traverseproc) IntervalIterator_traverse,
+    .tp_iter = PyObject_SelfIter,
     .tp_iternext = (iternextfunc) IntervalIterator_next,
-} 
-
-
-// PyTypeObject PySetIter_Type = {
-//     PyVarObject_HEAD_INIT(&PyType_Type, 0)
-//     "set_iterator",                             /* tp_name */
-//     sizeof(setiterobject),                      /* tp_basicsize */
-//     0,                                          /* tp_itemsize */
-//     /* methods */
-//     (destructor)setiter_dealloc,                /* tp_dealloc */
-//     0,                                          /* tp_vectorcall_offset */
-//     0,                                          /* tp_getattr */
-//     0,                                          /* tp_setattr */
-//     0,                                          /* tp_as_async */
-//     0,                                          /* tp_repr */
-//     0,                                          /* tp_as_number */
-//     0,                                          /* tp_as_sequence */
-//     0,                                          /* tp_as_mapping */
-//     0,                                          /* tp_hash */
-//     0,                                          /* tp_call */
-//     0,                                          /* tp_str */
-//     PyObject_GenericGetAttr,                    /* tp_getattro */
-//     0,                                          /* tp_setattro */
-//     0,                                          /* tp_as_buffer */
-//     Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,    /* tp_flags */
-//     0,                                          /* tp_doc */
-//     (traverseproc)setiter_traverse,             /* tp_traverse */
-//     0,                                          /* tp_clear */
-//     0,                                          /* tp_richcompare */
-//     0,                                          /* tp_weaklistoffset */
-//     PyObject_SelfIter,                          /* tp_iter */
-//     (iternextfunc)setiter_iternext,             /* tp_iternext */
-//     setiter_methods,                            /* tp_methods */
-//     0,
-// };
+    .tp_methods = IntervalIterator_methods,
+};
 
 #endif
-;
\ No newline at end of file
@@ -3,12 +3,13 @@
 
 #include <stdbool.h> // C99
 
-#if PYTHON_API_VERSION < 1100
+// Py_ALWAYS_INLINE only exists since python 3.11
+#ifndef Py_ALWAYS_INLINE
 #define Py_ALWAYS_INLINE 
 #endif
 
 
-// type of the predicate function used in the merge algorithm
+// type of the predicate function used in the merge algorithm, see MERGE_KERNEL
 typedef bool (*MergePredicate)(bool, bool);
 
 
@@ -29,4 +30,26 @@ static inline Py_ALWAYS_INLINE bool bitwiseSymmetricDifference(bool inLeft, bool
 }
 
 
+// type of the predicate used by the k-way merge, it gets whether the first operand covers a position,
+// the number of operands covering it, and the total number of operands
+typedef bool (*CoveragePredicate)(bool, Py_ssize_t, Py_ssize_t);
+
+
+static inline Py_ALWAYS_INLINE bool coverageUnion(bool Py_UNUSED(inFirst), Py_ssize_t covering, Py_ssize_t Py_UNUSED(operands)) {
+    return covering > 0;
+}
+
+static inline Py_ALWAYS_INLINE bool coverageIntersection(bool Py_UNUSED(inFirst), Py_ssize_t covering, Py_ssize_t operands) {
+    return covering == operands;
+}
+
+static inline Py_ALWAYS_INLINE bool coverageDifference(bool inFirst, Py_ssize_t covering, Py_ssize_t Py_UNUSED(operands)) {
+    return inFirst & (covering == 1);
+}
+
+static inline Py_ALWAYS_INLINE bool coverageSymmetricDifference(bool Py_UNUSED(inFirst), Py_ssize_t covering, Py_ssize_t Py_UNUSED(operands)) {
+    return covering % 2 != 0;
+}
+
+
 #endif
@@ -4,70 +4,554 @@
 
 #define PY_SSIZE_T_CLEAN
 #include <Python.h>
+#include <pthread.h>
+#include <stdbool.h>
 
 //#define PSET_DEBUG
 
 typedef uint32_t pset_boundary_t;
 pset_boundary_t MAX_BOUND_VALUE = (pset_boundary_t) -1;
 
+// number of boundaries stored inside the object itself, small procsets don't need another allocation
+#define PSET_INLINE_CAPACITY 4
+
 // Definition of the ProcSet struct
 typedef struct {
     // Python object boilerplate
     PyObject_HEAD
 
     // Boundaries of the ProcSet paired two by two as half-opened intervals
+    // points to _inline when they fit in it, to a PyMem buffer otherwise
     pset_boundary_t *_boundaries;   
 
     // the number of boundaries, (2x nbr of intervals)
     Py_ssize_t nb_boundary;
+
+    // the number of boundaries _boundaries has room for (>= nb_boundary)
+    Py_ssize_t capacity;
+
+    // the number of processors in the set, kept up to date by every function writing boundaries
+    Py_ssize_t length;
+
+    // lazily computed prefix sums of the interval lengths, _prefix[k] is the number of
+    // processors before the k-th interval. NULL until needed, dropped on every mutation.
+    Py_ssize_t *_prefix;
+
+    // the number of buffer views currently exported on _boundaries, the procset can't be modified
+    // while it is not 0
+    Py_ssize_t exports;
+
+    // the number of sweeps reading _boundaries without the GIL (see pset_begin_nogil), and of merges
+    // about to replace them (see _kway_merge_into). Modifications wait until it is back to 0
+    Py_ssize_t pins;
+
+    // the number of threads waiting for the pins to be released, new sweeps keep the GIL meanwhile
+    // so that the modifications are not starved
+    Py_ssize_t waiting;
+
+    // the hash of a FrozenProcSet, 0 until it is computed (a computed hash is never 0)
+    Py_hash_t hash;
+
+    // storage of the boundaries of small procsets (1 or 2 intervals)
+    pset_boundary_t _inline[PSET_INLINE_CAPACITY];
 } ProcSetObject;
 
 
-// a method that resizes a procset
-// nb_elements should always be > 0
-static int
-pset_resize(ProcSetObject* pset, Py_ssize_t nb_elements){
- 
-    // if the destination is smaller than the source: we need to allocate more memory
-    if (pset->nb_boundary < nb_elements){
-        pset_boundary_t * temp = PyMem_Realloc(pset->_boundaries, nb_elements * sizeof(pset_boundary_t));
+// the threads waiting in pset_wait_pins sleep on unpinned, which is broadcast whenever a procset
+// somebody waits for is unpinned. The pins are only changed with the GIL held: a waiter takes the lock
+// before dropping the GIL, so the broadcast can't happen between its check and its wait
+static struct {
+    pthread_mutex_t lock;
+    pthread_cond_t unpinned;
+    bool atfork;                    // whether pset_pins_atfork_child is registered
+} pset_pins = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .unpinned = PTHREAD_COND_INITIALIZER,
+};
 
-        if (!temp){
-            //we dont check for previous py errors since they would have been caught in the "if !result"
-            printf("old addr :%p, size: %li, taille demandee: %li\n", (void *) pset->_boundaries, pset->nb_boundary, nb_elements);
-            PyErr_SetString(PyExc_MemoryError, "Failed to realloc to a smaller size !");
-            return 0;           // return false
+// a waiter may have held the lock when the process forked
+static void
+pset_pins_atfork_child(void){
+    pthread_mutex_init(&pset_pins.lock, NULL);
+    pthread_cond_init(&pset_pins.unpinned, NULL);
+}
+
+// waits until the boundaries of pset are pinned at most remaining times, the GIL is dropped meanwhile
+// so that the threads sweeping them without it can finish
+static inline void
+pset_wait_pins(ProcSetObject* pset, Py_ssize_t remaining){
+    if (pset->pins <= remaining){
+        return;
+    }
+    if (!pset_pins.atfork){
+        pset_pins.atfork = pthread_atfork(NULL, NULL, pset_pins_atfork_child) == 0;
+    }
+
+    pset->waiting++;
+    while (pset->pins > remaining){
+        pthread_mutex_lock(&pset_pins.lock);
+        Py_BEGIN_ALLOW_THREADS
+        pthread_cond_wait(&pset_pins.unpinned, &pset_pins.lock);
+        pthread_mutex_unlock(&pset_pins.lock);
+        Py_END_ALLOW_THREADS
+    }
+    pset->waiting--;
+}
+
+// releases a pin taken with the GIL held, and wakes up the threads waiting for pset
+static inline void
+pset_unpin(ProcSetObject* pset){
+    pset->pins--;
+    if (pset->waiting){
+        pthread_mutex_lock(&pset_pins.lock);
+        pthread_cond_broadcast(&pset_pins.unpinned);
+        pthread_mutex_unlock(&pset_pins.lock);
+    }
+}
+
+// must be checked by every method right before it modifies the boundaries of an existing procset,
+// waits for the sweeps reading them without the GIL, then sets a BufferError and returns 0 while a
+// buffer view on them is alive. Nothing can pin the procset again until the GIL is released.
+// The GIL may be released while it waits: other threads can run, and drop references, meanwhile
+static inline int
+pset_check_mutable(ProcSetObject* pset){
+    pset_wait_pins(pset, 0);
+    if (pset->exports > 0){
+        PyErr_SetString(PyExc_BufferError, "Existing exports of data: ProcSet cannot be modified");
+        return 0;
+    }
+    return 1;
+}
+
+
+// sweeps over at least this many boundaries release the GIL, so that other threads can run meanwhile
+#define PSET_NOGIL_THRESHOLD 16384
+
+// Releases the GIL before a sweep over nb_boundary boundaries of the count procsets of list, if the sweep
+// is long enough and no thread is waiting to modify them. They are pinned first: they can't be modified
+// until pset_end_nogil.
+// Returns NULL if the GIL is kept, what it returns must be given to pset_end_nogil
+static inline PyThreadState *
+pset_begin_nogil(ProcSetObject * list[], Py_ssize_t count, Py_ssize_t nb_boundary){
+    if (nb_boundary < PSET_NOGIL_THRESHOLD){
+        return NULL;
+    }
+    for (Py_ssize_t i = 0; i < count; i++){
+        if (list[i]->waiting){
+            return NULL;
+        }
+    }
+    for (Py_ssize_t i = 0; i < count; i++){
+        list[i]->pins++;
+    }
+    return PyEval_SaveThread();
+}
+
+// takes the GIL back after a sweep started with pset_begin_nogil, and unpins the procsets
+static inline void
+pset_end_nogil(PyThreadState * state, ProcSetObject * list[], Py_ssize_t count){
+    if (!state){
+        return;
+    }
+    PyEval_RestoreThread(state);
+    for (Py_ssize_t i = 0; i < count; i++){
+        pset_unpin(list[i]);
+    }
+}
+
+
+// drops the caches computed from the boundaries, must be called after every mutation
+static inline void
+pset_invalidate_cache(ProcSetObject* pset){
+    PyMem_Free(pset->_prefix);
+    pset->_prefix = NULL;
+}
+
+
+// returns the number of processors in a list of boundaries
+static inline Py_ssize_t
+pset_count_processors(const pset_boundary_t * boundaries, Py_ssize_t nb_boundary){
+    Py_ssize_t res = 0;
+    for (Py_ssize_t i = 0; i + 1 < nb_boundary; i += 2){
+        res += boundaries[i+1] - boundaries[i];
+    }
+    return res;
+}
+
+// hash of a boundary array, 4 independent multiply-xor lanes fed with 2 boundaries each
+// so that the loop is not bound by the latency of a single dependency chain
+static Py_hash_t
+pset_hash_boundaries(const pset_boundary_t * boundaries, Py_ssize_t nb_boundary){
+    const uint64_t prime = 0x9E3779B97F4A7C15ULL;
+    uint64_t lanes[4] = {0x243F6A8885A308D3ULL, 0x13198A2E03707344ULL, 0xA4093822299F31D0ULL, 0x082EFA98EC4E6C89ULL};
+
+    Py_ssize_t i = 0;
+    for (; i + 8 <= nb_boundary; i += 8){
+        for (int lane = 0; lane < 4; lane++){
+            uint64_t word = boundaries[i + 2*lane] | ((uint64_t) boundaries[i + 2*lane + 1] << 32);
+            lanes[lane] = (lanes[lane] ^ word) * prime;
+            lanes[lane] ^= lanes[lane] >> 29;
         }
+    }
+    // the remaining boundaries, at most 7
+    for (int lane = 0; i < nb_boundary; i++, lane = (lane + 1) & 3){
+        lanes[lane] = (lanes[lane] ^ boundaries[i]) * prime;
+        lanes[lane] ^= lanes[lane] >> 29;
+    }
 
-        // we replace the adress if the new one is valid
-        // it could also be the same but we replace it anyway
-        pset->_boundaries = temp;        
-    } 
+    uint64_t h = (uint64_t) nb_boundary;
+    for (int lane = 0; lane < 4; lane++){
+        h = (h ^ lanes[lane]) * prime;
+        h = (h << 31) | (h >> 33);
+    }
+    // final avalanche (murmur3 fmix64)
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    h ^= h >> 33;
 
-    // if our list is bigger than the result's list
-    else if (pset->nb_boundary > nb_elements){
-        // we release the allocated memory for self->boundaries
-        // we cannot use realloc here because data was written outside of [0, nb_elements], so realloc would fail
+    Py_hash_t result = (Py_hash_t) h;
+    // -1 is an error for python, 0 means not computed for us
+    if (result == -1 || result == 0){
+        result = -2;
+    }
+    return result;
+}
+
+// releases the buffer of a procset, unless it is the inline one
+static inline void
+pset_free_boundaries(ProcSetObject* pset){
+    if (pset->_boundaries != pset->_inline){
         PyMem_Free(pset->_boundaries);
+    }
+    pset->_boundaries = NULL;
+    pset->capacity = 0;
+}
 
-        // we allocate the amount of memory (i don't think this one can fail, we literally just freed more than enough memory)
-        pset->_boundaries = (pset_boundary_t * ) PyMem_Malloc(pset->nb_boundary * sizeof(pset_boundary_t));
+// allocates room for capacity boundaries in a procset without boundaries
+static inline int
+pset_alloc_boundaries(ProcSetObject* pset, Py_ssize_t capacity){
+    if (capacity <= PSET_INLINE_CAPACITY){
+        pset->_boundaries = pset->_inline;
+        pset->capacity = PSET_INLINE_CAPACITY;
+        return 1;
     }
-    //we don't do anything if the sizes are equals
 
+    // PyMem_New fails instead of wrapping when the size in bytes overflows
+    pset->_boundaries = PyMem_New(pset_boundary_t, capacity);
+    if (!pset->_boundaries){
+        pset->capacity = 0;
+        PyErr_NoMemory();
+        return 0;
+    }
+
+    pset->capacity = capacity;
     return 1;
 }
 
-// copies nb_elements boundaries from the source procset into the destination procset
+// moves the boundaries of a procset into a buffer of exactly capacity (>= nb_boundary) boundaries,
+// the inline storage is used if they fit in it
 static int
-pset_copy(ProcSetObject* src, ProcSetObject *destination, Py_ssize_t nb_elements){
-    for (Py_ssize_t i = 0; i < nb_elements; i++){
-        destination->_boundaries[i] = src->_boundaries[i];
+pset_realloc_boundaries(ProcSetObject* pset, Py_ssize_t capacity){
+    bool is_inline = pset->_boundaries == pset->_inline;
+
+    // back to the inline storage
+    if (capacity <= PSET_INLINE_CAPACITY){
+        if (!is_inline){
+            if (pset->nb_boundary){
+                memcpy(pset->_inline, pset->_boundaries, pset->nb_boundary * sizeof(pset_boundary_t));
+            }
+            PyMem_Free(pset->_boundaries);
+            pset->_boundaries = pset->_inline;
+        }
+        pset->capacity = PSET_INLINE_CAPACITY;
+        return 1;
+    }
+
+    // we spill out of the inline storage
+    if (is_inline){
+        pset_boundary_t * temp = PyMem_New(pset_boundary_t, capacity);
+        if (!temp){
+            PyErr_NoMemory();
+            return 0;
+        }
+        memcpy(temp, pset->_inline, pset->nb_boundary * sizeof(pset_boundary_t));
+        pset->_boundaries = temp;
+        pset->capacity = capacity;
+        return 1;
+    }
+
+    // PyMem_Resize sets its pointer to NULL on failure, the buffer of pset is kept
+    pset_boundary_t * temp = pset->_boundaries;
+    PyMem_Resize(temp, pset_boundary_t, capacity);
+    if (!temp){
+        PyErr_NoMemory();
+        return 0;
     }
 
+    pset->_boundaries = temp;
+    pset->capacity = capacity;
     return 1;
 }
 
+// makes sure a procset has room for capacity boundaries, the existing boundaries are kept
+// the capacity grows geometrically so that repeated mutations rarely need to reallocate
+static int
+pset_reserve(ProcSetObject* pset, Py_ssize_t capacity){
+    if (capacity <= pset->capacity){
+        return 1;
+    }
+
+    Py_ssize_t new_capacity = pset->capacity > PY_SSIZE_T_MAX - (pset->capacity >> 1)
+                              ? capacity : pset->capacity + (pset->capacity >> 1);
+    if (new_capacity < capacity){
+        new_capacity = capacity;
+    }
+
+    return pset_realloc_boundaries(pset, new_capacity);
+}
+
+// releases the capacity of a procset that is not used by its boundaries
+static int
+pset_shrink_to_fit(ProcSetObject* pset){
+    // an empty procset has nothing to keep
+    if (!pset->nb_boundary){
+        pset_free_boundaries(pset);
+        return 1;
+    }
+
+    if (pset->capacity == pset->nb_boundary){
+        return 1;
+    }
+
+    return pset_realloc_boundaries(pset, pset->nb_boundary);
+}
+
+// releases the excess memory of a freshly built procset, if it uses less than half of its capacity
+// or if its boundaries fit in the inline storage
+static inline void
+pset_trim(ProcSetObject* pset){
+    if (pset->_boundaries == pset->_inline || !pset->nb_boundary){
+        return;
+    }
+
+    bool wasteful = pset->nb_boundary < pset->capacity / 2 || pset->nb_boundary <= PSET_INLINE_CAPACITY;
+    if (wasteful && !pset_shrink_to_fit(pset)){
+        // the previous buffer is still valid, there is nothing to report
+        PyErr_Clear();
+    }
+}
+
+// replaces the boundaries of a procset with the given PyMem buffer, which the procset now owns
+// small results are moved to the inline storage
+static inline void
+pset_replace_boundaries(ProcSetObject* pset, pset_boundary_t * boundaries, Py_ssize_t nb_boundary, Py_ssize_t capacity){
+    pset_free_boundaries(pset);
+
+    if (nb_boundary <= PSET_INLINE_CAPACITY){
+        memcpy(pset->_inline, boundaries, nb_boundary * sizeof(pset_boundary_t));
+        PyMem_Free(boundaries);
+        pset->_boundaries = pset->_inline;
+        pset->capacity = PSET_INLINE_CAPACITY;
+    } else {
+        pset->_boundaries = boundaries;
+        pset->capacity = capacity;
+    }
+
+    pset->nb_boundary = nb_boundary;
+    pset->length = pset_count_processors(pset->_boundaries, nb_boundary);
+    pset_invalidate_cache(pset);
+}
+
+// O(1) test telling apart most procsets with different contents, from data that every mutation
+// keeps up to date: the number of boundaries, the number of processors, the first and last
+// boundaries, and the hashes when both are cached (FrozenProcSet)
+static inline bool
+pset_fingerprint_differs(const ProcSetObject* lhs, const ProcSetObject* rhs){
+    Py_ssize_t nb = lhs->nb_boundary;
+    if (nb != rhs->nb_boundary || lhs->length != rhs->length){
+        return true;
+    }
+    if (!nb){
+        return false;
+    }
+    if (lhs->_boundaries[0] != rhs->_boundaries[0] || lhs->_boundaries[nb - 1] != rhs->_boundaries[nb - 1]){
+        return true;
+    }
+    return lhs->hash && rhs->hash && lhs->hash != rhs->hash;
+}
+
+// moves the boundaries of src into dst, src is left empty
+static inline void
+pset_steal_boundaries(ProcSetObject* dst, ProcSetObject* src){
+    pset_free_boundaries(dst);
+
+    if (src->_boundaries == src->_inline){
+        memcpy(dst->_inline, src->_inline, sizeof(src->_inline));
+        dst->_boundaries = dst->_inline;
+    } else {
+        dst->_boundaries = src->_boundaries;
+    }
+    dst->capacity = src->capacity;
+    dst->nb_boundary = src->nb_boundary;
+    dst->length = src->length;
+    pset_invalidate_cache(dst);
+
+    src->_boundaries = NULL;
+    src->capacity = 0;
+    src->nb_boundary = 0;
+    src->length = 0;
+}
+
+static int
+pset_compare_intervals(const void * a, const void * b){
+    pset_boundary_t lhs = *(const pset_boundary_t *) a, rhs = *(const pset_boundary_t *) b;
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+#define PSET_RADIX_BITS 11
+#define PSET_RADIX_THRESHOLD 256       // pairs, below it qsort is cheaper than the counting passes
+
+// LSD radix sort of [a, b[ pairs on a, 3 passes of 11 bits. returns 0 if the scratch buffer
+// could not be allocated, the pairs are then left untouched
+static int
+pset_radix_sort_intervals(pset_boundary_t * bounds, Py_ssize_t nb_pairs){
+    uint64_t * allocation = PyMem_Malloc(2 * nb_pairs * sizeof(uint64_t));
+    if (!allocation){
+        return 0;
+    }
+    uint64_t * items = allocation;
+    uint64_t * scratch = allocation + nb_pairs;
+
+    // a pair is moved as a single word, its lower bound in the low half
+    for (Py_ssize_t i = 0; i < nb_pairs; i++){
+        items[i] = (uint64_t) bounds[2*i] | ((uint64_t) bounds[2*i + 1] << 32);
+    }
+
+    const uint64_t mask = (1 << PSET_RADIX_BITS) - 1;
+    for (int shift = 0; shift < 32; shift += PSET_RADIX_BITS){
+        Py_ssize_t offsets[1 << PSET_RADIX_BITS] = {0};
+        for (Py_ssize_t i = 0; i < nb_pairs; i++){
+            offsets[((uint32_t) items[i] >> shift) & mask]++;
+        }
+        Py_ssize_t total = 0;
+        for (int d = 0; d <= (int) mask; d++){
+            Py_ssize_t count = offsets[d];
+            offsets[d] = total;
+            total += count;
+        }
+        for (Py_ssize_t i = 0; i < nb_pairs; i++){
+            scratch[offsets[((uint32_t) items[i] >> shift) & mask]++] = items[i];
+        }
+        uint64_t * swap = items;
+        items = scratch;
+        scratch = swap;
+    }
+
+    for (Py_ssize_t i = 0; i < nb_pairs; i++){
+        bounds[2*i] = (pset_boundary_t) items[i];
+        bounds[2*i + 1] = (pset_boundary_t) (items[i] >> 32);
+    }
+    PyMem_Free(allocation);
+    return 1;
+}
+
+// sorts nb boundaries seen as [a, b[ pairs on their lower bound and merges the ones that
+// overlap or touch, in place. returns the new number of boundaries
+static Py_ssize_t
+pset_sort_and_coalesce(pset_boundary_t * bounds, Py_ssize_t nb){
+    if (nb / 2 < PSET_RADIX_THRESHOLD || !pset_radix_sort_intervals(bounds, nb / 2)){
+        qsort(bounds, nb / 2, 2 * sizeof(pset_boundary_t), pset_compare_intervals);
+    }
+
+    Py_ssize_t w = 0;
+    for (Py_ssize_t r = 0; r < nb; r += 2){
+        if (w && bounds[r] <= bounds[w - 1]){
+            if (bounds[r + 1] > bounds[w - 1]){
+                bounds[w - 1] = bounds[r + 1];
+            }
+        } else {
+            bounds[w++] = bounds[r];
+            bounds[w++] = bounds[r + 1];
+        }
+    }
+    return w;
+}
+
+// accumulates [a, b[ pairs in any order into a single PyMem buffer, the pairs are only
+// sorted when they did not arrive sorted and disjoint
+typedef struct {
+    pset_boundary_t * bounds;
+    Py_ssize_t nb_boundary;
+    Py_ssize_t capacity;
+    bool sorted;
+} PSetBuilder;
+
+#define PSET_BUILDER_INIT {NULL, 0, 0, true}
+
+static inline int
+pset_builder_push(PSetBuilder * builder, pset_boundary_t lower, pset_boundary_t upper){
+    Py_ssize_t nb = builder->nb_boundary;
+    if (nb){
+        pset_boundary_t last = builder->bounds[nb - 1];
+        // contiguous with the previous pair: it is extended
+        if (lower == last){
+            builder->bounds[nb - 1] = upper;
+            return 1;
+        }
+        if (lower < last){
+            builder->sorted = false;
+        }
+    }
+
+    if (nb + 2 > builder->capacity){
+        Py_ssize_t capacity = builder->capacity + (builder->capacity >> 1);
+        if (capacity < 16){
+            capacity = 16;
+        }
+        pset_boundary_t * temp = PyMem_Realloc(builder->bounds, capacity * sizeof(pset_boundary_t));
+        if (!temp){
+            PyErr_NoMemory();
+            return 0;
+        }
+        builder->bounds = temp;
+        builder->capacity = capacity;
+    }
+
+    builder->bounds[nb] = lower;
+    builder->bounds[nb + 1] = upper;
+    builder->nb_boundary = nb + 2;
+    return 1;
+}
+
+// hands the accumulated boundaries over to pset, the builder is left empty
+static inline void
+pset_builder_finish(PSetBuilder * builder, ProcSetObject * pset){
+    Py_ssize_t nb = builder->nb_boundary;
+    if (!builder->sorted){
+        nb = pset_sort_and_coalesce(builder->bounds, nb);
+    }
+
+    if (nb){
+        pset_replace_boundaries(pset, builder->bounds, nb, builder->capacity);
+        pset_trim(pset);
+    } else {
+        PyMem_Free(builder->bounds);
+    }
+
+    builder->bounds = NULL;
+    builder->nb_boundary = builder->capacity = 0;
+    builder->sorted = true;
+}
+
+static inline void
+pset_builder_release(PSetBuilder * builder){
+    PyMem_Free(builder->bounds);
+    builder->bounds = NULL;
+    builder->nb_boundary = builder->capacity = 0;
+}
+
 #ifdef PSET_DEBUG
 static void
 debug_printprocset(ProcSetObject * self, Py_ssize_t predicted_elements){
@@ -1,17 +1,168 @@
 #include "intervaliterator.h"   // ici parceque erreur de compilation avec Python.h
+#include "elementiterator.h"
 #include <stdio.h>
 #include <stdint.h> // C99
 #include <string.h>
 #include <Python.h>
 #include "procsetheader.h"
 #include "mergepredicate.h"
+#include "threadpool.h"
 
 #define STR_BUFFER_SIZE 255
 
 static PyTypeObject ProcSetType;
+static PyTypeObject FrozenProcSetType;
+
+// true for the operands accepted by the set operations: ProcSet, FrozenProcSet and their subclasses
+#define PSet_Check(op) (PyObject_TypeCheck(op, &ProcSetType) || PyObject_TypeCheck(op, &FrozenProcSetType))
+#define FrozenPSet_Check(op) PyObject_TypeCheck(op, &FrozenProcSetType)
+
+// Free list of dead procsets, reused by the next allocations instead of tp_alloc / tp_free.
+// Exact ProcSets and FrozenProcSets share it: same struct, neither is tracked by the gc.
+// Bucket 0 holds procsets without a buffer, bucket k > 0 the ones keeping a PyMem buffer of
+// (PSET_INLINE_CAPACITY << (k - 1), PSET_INLINE_CAPACITY << k] boundaries, bigger buffers are released.
+// It relies on the GIL, and is disabled on free-threaded builds.
+#define PSET_FREELIST_BUCKETS 10
+#define PSET_FREELIST_SIZE 32           // the maximum number of procsets per bucket
+#ifdef Py_GIL_DISABLED
+#define PSET_FREELIST_ENABLED 0
+#else
+#define PSET_FREELIST_ENABLED 1
+#endif
+
+static struct {
+    ProcSetObject * items[PSET_FREELIST_BUCKETS][PSET_FREELIST_SIZE];
+    int sizes[PSET_FREELIST_BUCKETS];
+
+    // counters reported by _alloc_stats()
+    unsigned long long allocations;     // procsets of a type using the free list, allocated or reused
+    unsigned long long reused_objects;  // the ones taken from the free list
+    unsigned long long reused_buffers;  // the ones that also got the buffer they needed from it
+    unsigned long long released;        // dead procsets put in the free list
+} pset_freelist;
+
+// the bucket of the buffers of capacity boundaries, PSET_FREELIST_BUCKETS if they are too big to be kept
+static inline int
+_freelist_bucket(Py_ssize_t capacity){
+    int bucket = 0;
+    while (bucket < PSET_FREELIST_BUCKETS && capacity > (PSET_INLINE_CAPACITY << bucket)){
+        bucket++;
+    }
+    return bucket;
+}
+
+#define _freelist_uses(type) (PSET_FREELIST_ENABLED && ((type) == &ProcSetType || (type) == &FrozenProcSetType))
+
+// takes a procset of bucket out of the free list, if its buffer has room for capacity boundaries
+static ProcSetObject *
+_freelist_pop(PyTypeObject * type, int bucket, Py_ssize_t capacity){
+    if (bucket >= PSET_FREELIST_BUCKETS || !pset_freelist.sizes[bucket]){
+        return NULL;
+    }
+
+    ProcSetObject * pset = pset_freelist.items[bucket][pset_freelist.sizes[bucket] - 1];
+    if (pset->capacity < capacity){
+        return NULL;
+    }
+
+    pset_freelist.sizes[bucket]--;
+    pset_freelist.reused_objects++;
+    pset_freelist.reused_buffers += bucket > 0;
+    PyObject_Init((PyObject *) pset, type);     // a new reference, of the requested type
+    pset->nb_boundary = 0;
+    pset->length = 0;
+    pset->hash = 0;
+    return pset;
+}
+
+// puts a dead procset in the free list, returns 0 if it is full and the procset must be freed
+static int
+_freelist_push(ProcSetObject * pset){
+    if (!_freelist_uses(Py_TYPE(pset))){
+        return 0;
+    }
+
+    int bucket = pset->_boundaries == pset->_inline ? 0 : _freelist_bucket(pset->capacity);
+    if (bucket == PSET_FREELIST_BUCKETS || (bucket && pset_freelist.sizes[bucket] == PSET_FREELIST_SIZE)){
+        bucket = 0;
+    }
+    if (pset_freelist.sizes[bucket] == PSET_FREELIST_SIZE){
+        return 0;
+    }
+    if (!bucket){
+        pset_free_boundaries(pset);
+    }
+
+    pset_freelist.items[bucket][pset_freelist.sizes[bucket]++] = pset;
+    pset_freelist.released++;
+    return 1;
+}
+
+// releases every procset of the free list
+static void
+_freelist_clear(void){
+    for (int bucket = 0; bucket < PSET_FREELIST_BUCKETS; bucket++){
+        while (pset_freelist.sizes[bucket]){
+            ProcSetObject * pset = pset_freelist.items[bucket][--pset_freelist.sizes[bucket]];
+            pset_free_boundaries(pset);
+            PyObject_Free(pset);
+        }
+    }
+}
+
+// an empty procset of the given type, without going through its constructor
+static inline ProcSetObject *
+_pset_new(PyTypeObject * type){
+    if (_freelist_uses(type)){
+        pset_freelist.allocations++;
+        ProcSetObject * pset = _freelist_pop(type, 0, 0);
+        if (pset){
+            return pset;
+        }
+    }
+    return (ProcSetObject *) type->tp_alloc(type, 0);
+}
+
+// an empty procset of the given type with room for capacity boundaries
+// a buffer big enough is taken from the free list when there is one
+static ProcSetObject *
+_pset_alloc(PyTypeObject * type, Py_ssize_t capacity){
+    if (_freelist_uses(type) && capacity > PSET_INLINE_CAPACITY){
+        // the top of the bucket of capacity may be too small, any buffer of the next one is big enough
+        int bucket = _freelist_bucket(capacity);
+        ProcSetObject * pset = _freelist_pop(type, bucket, capacity);
+        if (!pset){
+            pset = _freelist_pop(type, bucket + 1, capacity);
+        }
+        if (pset){
+            pset_freelist.allocations++;
+            return pset;
+        }
+    }
+
+    ProcSetObject * pset = _pset_new(type);
+    if (pset && !pset_alloc_boundaries(pset, capacity)){
+        Py_DECREF(pset);
+        return NULL;
+    }
+    return pset;
+}
+
+// returns a procset of the given type with the boundaries of pset, which must not be shared
+// pset is consumed
+static ProcSetObject *
+_pset_cast(ProcSetObject * pset, PyTypeObject * type){
+    if (!pset || Py_IS_TYPE(pset, type)){
+        return pset;
+    }
 
-// Update type, used by the _update_core function
-typedef PyObject * (* InplaceType) (ProcSetObject *, PyObject *);
+    ProcSetObject * result = _pset_new(type);
+    if (result){
+        pset_steal_boundaries(result, pset);
+    }
+    Py_DECREF(pset);
+    return result;
+}
 
 // returns true if the object is iterable
 static int
@@ -48,24 +199,66 @@ ProcSet_intervals(ProcSetObject *self, void * Py_UNUSED(args)){
     return iter;
 }
 
-// returns a shallow copy of the object
-PyObject * 
-ProcSet_copy(ProcSetObject *self, void * Py_UNUSED(args)){
-    // another object
-    ProcSetObject* copy = (ProcSetObject *) ProcSetType.tp_alloc(&ProcSetType, 0);
+// intervals_list([start[, stop]]): the intervals as a list of (a, b) tuples, built in a single call
+// start and stop select a chunk of intervals, like a slice of the result of intervals()
+static PyObject *
+ProcSet_intervalsList(ProcSetObject *self, PyObject * const * args, Py_ssize_t nargs){
+    Py_ssize_t nb_itv = self->nb_boundary / 2;
+    Py_ssize_t start = 0, stop = nb_itv;
+    if (nargs > 2){
+        PyErr_Format(PyExc_TypeError, "intervals_list() takes at most 2 arguments (%zd given)", nargs);
+        return NULL;
+    }
+    if (nargs > 0 && (start = PyNumber_AsSsize_t(args[0], PyExc_OverflowError)) == -1 && PyErr_Occurred()){
+        return NULL;
+    }
+    if (nargs > 1 && (stop = PyNumber_AsSsize_t(args[1], PyExc_OverflowError)) == -1 && PyErr_Occurred()){
+        return NULL;
+    }
+    PySlice_AdjustIndices(nb_itv, &start, &stop, 1);
 
-    // we copy the nbr of boundaries
-    copy->nb_boundary = self->nb_boundary;
+    PyObject * list = PyList_New(stop > start ? stop - start : 0);
+    if (!list){
+        return NULL;
+    }
 
-    // we allocate memory to store the boundaries 
-    copy->_boundaries = (pset_boundary_t *) PyMem_Malloc( copy->nb_boundary * sizeof(pset_boundary_t));
-    if (self->_boundaries && !copy->_boundaries){
-        Py_DECREF((PyObject* )copy);        // we allow the copy to be gc'ed TODO: use dealloc
+    for (Py_ssize_t itv = start; itv < stop; itv++){
+        PyObject * tuple = _interval_tuple(self->_boundaries[2*itv], self->_boundaries[2*itv + 1] - 1);
+        if (!tuple){
+            Py_DECREF(list);
+            return NULL;
+        }
+        PyList_SET_ITEM(list, itv - start, tuple);
+    }
 
-        PyErr_NoMemory();
+    return list;
+}
+
+// __iter__: the processors in increasing order
+static PyObject *
+ProcSet_iter(ProcSetObject *self){
+    return ElementIterator_new(self, false);
+}
+
+// __reversed__: the processors in decreasing order
+static PyObject *
+ProcSet_reversed(ProcSetObject *self, PyObject *Py_UNUSED(args)){
+    return ElementIterator_new(self, true);
+}
+
+// returns a copy of pset of the given type
+static PyObject *
+_pset_copy(ProcSetObject *self, PyTypeObject * type){
+    // another object, with memory to store the boundaries
+    ProcSetObject* copy = _pset_alloc(type, self->nb_boundary);
+    if (!copy){
         return NULL;
     }
 
+    // we copy the nbr of boundaries
+    copy->nb_boundary = self->nb_boundary;
+    copy->length = self->length;
+
     // we copy every value in the boundary array
     for (int i = 0; i < self->nb_boundary; i++){
         copy->_boundaries[i] = self->_boundaries[i];
@@ -74,35 +267,39 @@ ProcSet_copy(ProcSetObject *self, void * Py_UNUSED(args)){
     return (PyObject *) copy;
 }
 
+// returns a shallow copy of the object
+PyObject * 
+ProcSet_copy(ProcSetObject *self, void * Py_UNUSED(args)){
+    return _pset_copy(self, &ProcSetType);
+}
+
 // returns a deep (yet shallow) copy of the object
 static PyObject *
-ProcSet_deepcopy(ProcSetObject *self, PyObject * args){
-    // args is here to act as "memo", but it's useless here
-    return ProcSet_copy(self, args);
+ProcSet_deepcopy(ProcSetObject *self, PyObject * memo){
+    // memo is useless here, the boundaries are not python objects
+    return ProcSet_copy(self, memo);
 }
 
 // returns the convex hull of the procset
 static PyObject *
 ProcSet_aggregate(ProcSetObject *self, PyObject *Py_UNUSED(args))
 {
-    // the resulting procset
-    ProcSetObject *result = PyObject_New(ProcSetObject, &ProcSetType);
+    // the resulting procset, of the same kind as self
+    ProcSetObject *result = _pset_new(FrozenPSet_Check(self) ? Py_TYPE(self) : &ProcSetType);
     if (!result) {
-        PyErr_NoMemory();
         return NULL;
     }
 
-    result->_boundaries = (pset_boundary_t *) PyMem_Malloc(2 * sizeof(pset_boundary_t));
-    if (!result->_boundaries) {
-        PyErr_NoMemory();
+    if (!pset_alloc_boundaries(result, 2)) {
         Py_DECREF(result);
         return NULL;
     }
 
-    if (self->_boundaries){
+    if (self->nb_boundary){
         result->_boundaries[0] = self->_boundaries[0];
         result->_boundaries[1] = self->_boundaries[self->nb_boundary-1]; 
         result->nb_boundary = 2;
+        result->length = result->_boundaries[1] - result->_boundaries[0];
     } else {
         result->nb_boundary = 0;
     }
@@ -114,67 +311,485 @@ ProcSet_aggregate(ProcSetObject *self, PyObject *Py_UNUSED(args))
 // removes every element of the pset
 static PyObject *
 ProcSet_clear(ProcSetObject *self, PyObject *Py_UNUSED(args)){
-    PyMem_Free(self->_boundaries);
+    if (!pset_check_mutable(self)){
+        return NULL;
+    }
+
+    // the buffer is kept, its capacity will be reused by the next mutations
     self->nb_boundary = 0;
+    self->length = 0;
+    pset_invalidate_cache(self);
+
+    Py_RETURN_NONE;
+}
+
+
+// Galloping is used by the merge kernel when one operand has at least gallop_ratio times
+// more boundaries than the other one (0 disables it), see set_gallop_ratio()
+static Py_ssize_t gallop_ratio = 8;
+
+// the most boundaries a procset can have: every value of pset_boundary_t, in a buffer of at most PY_SSIZE_T_MAX bytes
+#define PSET_MAX_BOUNDARIES ((Py_ssize_t) Py_MIN((uint64_t) UINT32_MAX + 1, (uint64_t) PY_SSIZE_T_MAX / sizeof(pset_boundary_t)))
+
+// gallop_ratio times the size of an operand must fit in a Py_ssize_t
+#define PSET_MAX_GALLOP_RATIO (PY_SSIZE_T_MAX / PSET_MAX_BOUNDARIES)
+
+// returns the index of the first boundary >= value in boundaries[from, size[, boundaries[from] < value
+// exponential search followed by a binary search, O(log(distance)) instead of O(distance)
+static Py_ssize_t
+_gallop(const pset_boundary_t * boundaries, Py_ssize_t from, Py_ssize_t size, pset_boundary_t value){
+    // boundaries[low] < value, boundaries[high] >= value (or high == size)
+    Py_ssize_t low = from, high = from + 1, step = 1;
+    while (high < size && boundaries[high] < value){
+        low = high;
+        step <<= 1;
+        high = from + step;
+    }
+    if (high > size){
+        high = size;
+    }
+
+    while (high - low > 1){
+        Py_ssize_t mid = low + (high - low) / 2;
+        if (boundaries[mid] < value){
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    return high;
+}
+
+// One step of the linear merge: the smallest head is processed, and the lists starting with it move past it.
+// There is no branch in it: whether a boundary is kept, and which list moves, depend on the data,
+// as branches they would be mispredicted about half of the time.
+static inline Py_ALWAYS_INLINE void
+_merge_step(pset_boundary_t lhead, pset_boundary_t rhead, Py_ssize_t * lbound_index, Py_ssize_t * rbound_index,
+            pset_boundary_t * out, Py_ssize_t * nb_boundary, bool * side, MergePredicate operator){
+    pset_boundary_t head = (lhead < rhead) ? lhead : rhead;
+    *lbound_index += lhead <= rhead;
+    *rbound_index += rhead <= lhead;
+
+    // right after head, a list is inside one of its intervals if it is now on an upper bound
+    bool keep = operator(*lbound_index%2 != 0, *rbound_index%2 != 0);
+
+    // the head is always written, and only kept by moving past it when it changes the side.
+    // Writing it unconditionally is safe, out[*nb_boundary] is where it would have been written anyway
+    out[*nb_boundary] = head;
+    *nb_boundary += keep ^ *side;
+    *side = keep;
+}
+
+// MERGE KERNEL (Core function)
+// Merges two boundary lists into out, which must have room for lsize + rsize boundaries.
+// Returns the number of boundaries written in out. out may overlap the end of the buffer
+// lbounds is in, as long as it starts at least rsize boundaries before lbounds (see _kway_merge_into).
+//
+// When the sizes are very different (see gallop_ratio, given as ratio), the kernel gallops through the bigger
+// list: while its head is below the head of the smaller one, the smaller one stays either inside or outside an interval,
+// so the boundaries of the bigger list are either all kept or all dropped. They are found with
+// _gallop and copied (or skipped) in one go, which makes the merge O(m log(n/m)).
+//
+// The kernel can also merge the boundaries lbounds[lstart, lsize[ and rbounds[rstart, rsize[ only, which are
+// the partitions of a parallel merge (see _binary_merge). The parity of the indices tells whether each list is
+// inside an interval at the start of the partition, so is the result: it starts with an upper bound if it is.
+//
+// It is never called directly: MERGE_KERNEL stamps one specialization per operation, in which
+// operator is inlined, so the inner loop is compiled without any call.
+static inline Py_ALWAYS_INLINE Py_ssize_t
+merge_kernel(const pset_boundary_t * lbounds, Py_ssize_t lstart, Py_ssize_t lsize,
+             const pset_boundary_t * rbounds, Py_ssize_t rstart, Py_ssize_t rsize,
+             pset_boundary_t * out, Py_ssize_t ratio, MergePredicate operator){
+    Py_ssize_t nb_boundary = 0;
+    Py_ssize_t lbound_index = lstart, rbound_index = rstart;
+
+    //false if lower bound, true if upper
+    bool side = operator(lbound_index%2 != 0, rbound_index%2 != 0);
+
+    // which list we may gallop through, if any
+    bool lgallop = ratio && lsize - lstart >= ratio * (rsize - rstart);
+    bool rgallop = ratio && rsize - rstart >= ratio * (lsize - lstart) && !lgallop;
+
+    if (!lgallop && !rgallop){
+        // a loop of its own, the compiler would otherwise test the heads before the gallop flags
+        while (lbound_index < lsize && rbound_index < rsize) {
+            _merge_step(lbounds[lbound_index], rbounds[rbound_index], &lbound_index, &rbound_index,
+                        out, &nb_boundary, &side, operator);
+        }
+    }
+
+    while (lbound_index < lsize && rbound_index < rsize) {
+        pset_boundary_t lhead = lbounds[lbound_index];
+        pset_boundary_t rhead = rbounds[rbound_index];
+
+        //is this list on an upper bound or on a lower bound ?
+        bool lside = lbound_index%2 != 0;
+        bool rside = rbound_index%2 != 0;
+
+        if (lgallop && lhead < rhead){
+            // the right list is inside an interval on [lhead, rhead[ if rhead is an upper bound
+            // the boundaries of the left list are kept if they change the result of the operator
+            if (operator(false, rside) != operator(true, rside)){
+                Py_ssize_t next = _gallop(lbounds, lbound_index, lsize, rhead);
+                memmove(out + nb_boundary, lbounds + lbound_index, (next - lbound_index) * sizeof(pset_boundary_t));
+                nb_boundary += next - lbound_index;
+                side ^= (next - lbound_index) % 2 != 0;
+                lbound_index = next;
+            } else {
+                lbound_index = _gallop(lbounds, lbound_index, lsize, rhead);
+            }
+            continue;
+        }
+        if (rgallop && rhead < lhead){
+            // same thing, the other way around
+            if (operator(lside, false) != operator(lside, true)){
+                Py_ssize_t next = _gallop(rbounds, rbound_index, rsize, lhead);
+                memmove(out + nb_boundary, rbounds + rbound_index, (next - rbound_index) * sizeof(pset_boundary_t));
+                nb_boundary += next - rbound_index;
+                side ^= (next - rbound_index) % 2 != 0;
+                rbound_index = next;
+            } else {
+                rbound_index = _gallop(rbounds, rbound_index, rsize, lhead);
+            }
+            continue;
+        }
+
+        _merge_step(lhead, rhead, &lbound_index, &rbound_index, out, &nb_boundary, &side, operator);
+    }
+
+    // one of the lists is over, outside of any interval (unless a partition ends inside one of its intervals).
+    // The boundaries left in the other list are either all kept, or all dropped
+    bool lside = lbound_index%2 != 0;
+    bool rside = rbound_index%2 != 0;
+    if (lbound_index < lsize && operator(false, rside) != operator(true, rside)){
+        memmove(out + nb_boundary, lbounds + lbound_index, (lsize - lbound_index) * sizeof(pset_boundary_t));
+        nb_boundary += lsize - lbound_index;
+    } else if (rbound_index < rsize && operator(lside, false) != operator(lside, true)){
+        memmove(out + nb_boundary, rbounds + rbound_index, (rsize - rbound_index) * sizeof(pset_boundary_t));
+        nb_boundary += rsize - rbound_index;
+    }
+
+    return nb_boundary;
+}
+
+// type of the merge kernel of an operation
+typedef Py_ssize_t (*MergeKernel)(const pset_boundary_t *, Py_ssize_t, const pset_boundary_t *, Py_ssize_t, pset_boundary_t *,
+                                  Py_ssize_t);
+
+// type of the merge kernel of an operation on a partition of the lists
+typedef Py_ssize_t (*MergeRangeKernel)(const pset_boundary_t *, Py_ssize_t, Py_ssize_t,
+                                       const pset_boundary_t *, Py_ssize_t, Py_ssize_t, pset_boundary_t *, Py_ssize_t);
+
+// stamps the merge kernels of an operation, on whole lists (name) and on partitions (name##Range),
+// with its predicate inlined
+#define MERGE_KERNEL(name, predicate)                                                                       \
+    static Py_ssize_t                                                                                       \
+    name(const pset_boundary_t * lbounds, Py_ssize_t lsize, const pset_boundary_t * rbounds, Py_ssize_t rsize, \
+         pset_boundary_t * out, Py_ssize_t ratio){                                                          \
+        return merge_kernel(lbounds, 0, lsize, rbounds, 0, rsize, out, ratio, predicate);                   \
+    }                                                                                                       \
+    static Py_ssize_t                                                                                       \
+    name##Range(const pset_boundary_t * lbounds, Py_ssize_t lstart, Py_ssize_t lsize,                       \
+                const pset_boundary_t * rbounds, Py_ssize_t rstart, Py_ssize_t rsize, pset_boundary_t * out,  \
+                Py_ssize_t ratio){                                                                          \
+        return merge_kernel(lbounds, lstart, lsize, rbounds, rstart, rsize, out, ratio, predicate);         \
+    }
+
+MERGE_KERNEL(mergeUnion, bitwiseUnion)
+MERGE_KERNEL(mergeIntersection, bitwiseIntersection)
+MERGE_KERNEL(mergeDifference, bitwiseDifference)
+MERGE_KERNEL(mergeSymmetricDifference, bitwiseSymmetricDifference)
+
+#undef MERGE_KERNEL
+
+
+// a set operation, with the kernels used for two operands and the predicate used for any number of operands
+typedef struct {
+    MergeKernel binary;
+    MergeRangeKernel partition;
+    CoveragePredicate nary;
+} SetOperation;
+
+static const SetOperation setUnion = {mergeUnion, mergeUnionRange, coverageUnion};
+static const SetOperation setIntersection = {mergeIntersection, mergeIntersectionRange, coverageIntersection};
+static const SetOperation setDifference = {mergeDifference, mergeDifferenceRange, coverageDifference};
+static const SetOperation setSymmetricDifference = {mergeSymmetricDifference, mergeSymmetricDifferenceRange,
+                                                    coverageSymmetricDifference};
+
+
+// Merges of two lists of at least 2 * PSET_PARALLEL_PART boundaries are split in partitions of at least
+// PSET_PARALLEL_PART boundaries, merged by up to merge_threads threads (1 disables it), see set_merge_threads()
+#define PSET_PARALLEL_PART (1 << 17)
+static Py_ssize_t merge_threads = 1;
+
+// a partition of a parallel merge, the boundaries of both lists between two pivot values
+typedef struct {
+    Py_ssize_t lstart, lend;
+    Py_ssize_t rstart, rend;
+    Py_ssize_t nb_boundary;     // the number of boundaries of its result, written at out + lstart + rstart
+    Py_ssize_t signed_sum;      // the sum of its result, upper bounds counted positively if it starts with a lower bound
+} MergePartition;
+
+// a parallel merge, shared by the threads of the pool
+typedef struct {
+    MergeRangeKernel kernel;
+    Py_ssize_t ratio;           // the gallop ratio of the kernel
+    const pset_boundary_t * lbounds;
+    const pset_boundary_t * rbounds;
+    pset_boundary_t * out;
+    MergePartition partitions[PSET_POOL_MAX_THREADS];
+} ParallelMerge;
+
+// returns the index of the first boundary >= value in boundaries[0, size[
+static Py_ssize_t
+_lower_bound(const pset_boundary_t * boundaries, Py_ssize_t size, pset_boundary_t value){
+    Py_ssize_t low = 0, high = size;
+    while (low < high){
+        Py_ssize_t mid = low + (high - low) / 2;
+        if (boundaries[mid] < value){
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// returns the k-th smallest boundary of both lists (co-ranking: the k smallest boundaries are
+// lbounds[0, i[ and rbounds[0, k - i[, i is found by a binary search), k < lsize + rsize
+static pset_boundary_t
+_corank_value(const pset_boundary_t * lbounds, Py_ssize_t lsize, const pset_boundary_t * rbounds, Py_ssize_t rsize, Py_ssize_t k){
+    Py_ssize_t low = k > rsize ? k - rsize : 0;
+    Py_ssize_t high = k < lsize ? k : lsize;
+    while (low < high){
+        Py_ssize_t i = low + (high - low) / 2;
+        if (lbounds[i] < rbounds[k - i - 1]){
+            low = i + 1;
+        } else {
+            high = i;
+        }
+    }
+
+    Py_ssize_t j = k - low;
+    if (low == lsize){
+        return rbounds[j];
+    }
+    if (j == rsize){
+        return lbounds[low];
+    }
+    return lbounds[low] < rbounds[j] ? lbounds[low] : rbounds[j];
+}
+
+// a task of the pool: merges one partition
+static void
+_merge_partition(void * arg, Py_ssize_t index){
+    ParallelMerge * merge = (ParallelMerge *) arg;
+    MergePartition * part = &merge->partitions[index];
+    pset_boundary_t * out = merge->out + part->lstart + part->rstart;
+
+    part->nb_boundary = merge->kernel(merge->lbounds, part->lstart, part->lend, merge->rbounds, part->rstart, part->rend, out,
+                                     merge->ratio);
+
+    // the sum of the upper bounds minus the sum of the lower bounds is the number of processors
+    Py_ssize_t sum = 0;
+    for (Py_ssize_t i = 0; i < part->nb_boundary; i++){
+        sum += (i % 2) ? (Py_ssize_t) out[i] : -(Py_ssize_t) out[i];
+    }
+    part->signed_sum = sum;
+}
+
+// MERGE OF TWO LISTS (Core function)
+// Merges two boundary lists with operation into out, which must have room for lsize + rsize boundaries,
+// and sets *length (unless NULL) to the number of processors of the result. Returns the number of boundaries written in out.
+// It does not need the GIL: ratio and threads are gallop_ratio and merge_threads, read by the caller while it holds it.
+//
+// Big lists are merged in parallel: both are cut at the same pivot values, the k-th smallest boundaries for
+// evenly spaced k, so that every partition has about the same number of boundaries. Each partition is merged
+// in its own part of out by a thread of the pool. As the cuts are made at the same values in both lists, the
+// result of a partition picks up where the previous one stops, they only need to be moved next to each other.
+// It is merged serially if the pool is busy with another merge.
+static Py_ssize_t
+_binary_merge(const SetOperation * operation, const pset_boundary_t * lbounds, Py_ssize_t lsize,
+              const pset_boundary_t * rbounds, Py_ssize_t rsize, pset_boundary_t * out, Py_ssize_t * length,
+              Py_ssize_t ratio, Py_ssize_t threads){
+    Py_ssize_t nb_parts = (lsize + rsize) / PSET_PARALLEL_PART;
+    if (nb_parts > threads){
+        nb_parts = threads;
+    }
+
+    ParallelMerge merge;
+    if (nb_parts > 1){
+        merge.kernel = operation->partition;
+        merge.ratio = ratio;
+        merge.lbounds = lbounds;
+        merge.rbounds = rbounds;
+        merge.out = out;
+
+        Py_ssize_t lcut = 0, rcut = 0;
+        for (Py_ssize_t p = 0; p < nb_parts; p++){
+            merge.partitions[p].lstart = lcut;
+            merge.partitions[p].rstart = rcut;
+            if (p + 1 < nb_parts){
+                pset_boundary_t pivot = _corank_value(lbounds, lsize, rbounds, rsize, (p + 1) * (lsize + rsize) / nb_parts);
+                lcut = _lower_bound(lbounds, lsize, pivot);
+                rcut = _lower_bound(rbounds, rsize, pivot);
+            } else {
+                lcut = lsize;
+                rcut = rsize;
+            }
+            merge.partitions[p].lend = lcut;
+            merge.partitions[p].rend = rcut;
+        }
+    }
+
+    if (nb_parts > 1 && pset_pool_run(nb_parts, _merge_partition, &merge, (int) nb_parts)){
+        Py_ssize_t nb_boundary = 0, processors = 0;
+        for (Py_ssize_t p = 0; p < nb_parts; p++){
+            MergePartition * part = &merge.partitions[p];
+            memmove(out + nb_boundary, out + part->lstart + part->rstart, part->nb_boundary * sizeof(pset_boundary_t));
+            // a partition starting at an odd position starts with an upper bound
+            processors += (nb_boundary % 2) ? -part->signed_sum : part->signed_sum;
+            nb_boundary += part->nb_boundary;
+        }
+        if (length){
+            *length = processors;
+        }
+        return nb_boundary;
+    }
+
+    Py_ssize_t nb_boundary = operation->binary(lbounds, lsize, rbounds, rsize, out, ratio);
+    if (length){
+        *length = pset_count_processors(out, nb_boundary);
+    }
+    return nb_boundary;
+}
+
+
+// reserve: makes room for n intervals
+static PyObject *
+ProcSet_reserve(ProcSetObject *self, PyObject *arg){
+    if (!pset_check_mutable(self)){
+        return NULL;
+    }
+
+    Py_ssize_t nb_itv = PyLong_AsSsize_t(arg);
+    if (nb_itv == -1 && PyErr_Occurred()){
+        return NULL;
+    }
+    if (nb_itv < 0){
+        PyErr_SetString(PyExc_ValueError, "cannot reserve a negative number of intervals");
+        return NULL;
+    }
+    // the size of the buffer in bytes must fit in a Py_ssize_t
+    if (nb_itv > PY_SSIZE_T_MAX / (2 * (Py_ssize_t) sizeof(pset_boundary_t))){
+        PyErr_SetString(PyExc_OverflowError, "cannot reserve that many intervals");
+        return NULL;
+    }
+
+    // we want exactly what was asked for, not the geometric growth
+    if (2 * nb_itv > self->capacity && !pset_realloc_boundaries(self, 2 * nb_itv)){
+        return NULL;
+    }
+
+    Py_RETURN_NONE;
+}
+
+// shrink_to_fit: releases the unused capacity
+static PyObject *
+ProcSet_shrinkToFit(ProcSetObject *self, PyObject *Py_UNUSED(args)){
+    if (!pset_check_mutable(self) || !pset_shrink_to_fit(self)){
+        return NULL;
+    }
 
     Py_RETURN_NONE;
 }
 
+// capacity: the number of intervals the procset can hold without reallocating
+static PyObject *
+ProcSet_capacity(ProcSetObject *self, void * Py_UNUSED(v)){
+    return PyLong_FromSsize_t(self->capacity / 2);
+}
+
 
 // MERGE (Core function)
 static PyObject*
-merge(ProcSetObject* lpset,ProcSetObject* rpset, MergePredicate operator){
-    PyTypeObject * psettype = ((PyObject*) lpset)->ob_type;     //TODO : replace with &ProcSetType
-
+merge(ProcSetObject* lpset,ProcSetObject* rpset, const SetOperation * operation){
     //the potential max nbr of intervals
     Py_ssize_t maxBound = lpset->nb_boundary + rpset->nb_boundary;
 
-    //the resulting procset
-    ProcSetObject* result = (ProcSetObject *) psettype->tp_new(psettype, NULL, NULL);
-
+    //the resulting procset, of the type of the left operand (like set and frozenset)
     //we take more than we should, that's ok
-    result->_boundaries = (pset_boundary_t *) PyMem_Malloc(sizeof(pset_boundary_t) * maxBound);
-    if (!result->_boundaries){
-        PyErr_NoMemory();                 
-        Py_DECREF((PyObject*) result);
+    ProcSetObject* result = _pset_alloc(Py_TYPE(lpset), maxBound);
+    if (!result){
         return NULL;
     }
 
-    bool side = false;                          //false if lower bound, true if upper
+    // result is not shared yet, only the operands need to be pinned
+    // the settings are read with the GIL, another thread may change them during the merge
+    Py_ssize_t ratio = gallop_ratio, threads = merge_threads;
+    ProcSetObject * operands[2] = {lpset, rpset};
+    PyThreadState * state = pset_begin_nogil(operands, 2, maxBound);
+    result->nb_boundary = _binary_merge(operation, lpset->_boundaries, lpset->nb_boundary, rpset->_boundaries, rpset->nb_boundary,
+                                        result->_boundaries, &result->length, ratio, threads);
+    pset_end_nogil(state, operands, 2);
+
+    // we free the excess memory if we took way too much
+    pset_trim(result);
+
+    return (PyObject *) result;
+}
+
+// flags returned by relation_sweep, one for each kind of region the sweep can go through
+#define PSET_LEFT_ONLY  1       // a processor of lpset that is not in rpset
+#define PSET_RIGHT_ONLY 2       // a processor of rpset that is not in lpset
+#define PSET_COMMON     4       // a processor found in both lpset and rpset
+
+// RELATION SWEEP (Core function)
+// Walks both boundary lists the same way merge does, but instead of building a result
+// it records the kind of every region it goes through. The sweep stops on the first
+// region matching one of the stop_on flags, so it never allocates and usually exits early.
+// It only reads plain buffers, and can run without the GIL (see relation_sweep).
+static int
+relation_kernel(const pset_boundary_t * lbounds, Py_ssize_t lsize, const pset_boundary_t * rbounds, Py_ssize_t rsize, int stop_on){
+    int found = 0;
 
     pset_boundary_t sentinel = UINT32_MAX;
 
     Py_ssize_t lbound_index = 0, rbound_index = 0;
-    pset_boundary_t lhead = lpset->nb_boundary ? lpset->_boundaries[lbound_index] : sentinel;
-    pset_boundary_t rhead = rpset->nb_boundary ? rpset->_boundaries[rbound_index] : sentinel;
+    pset_boundary_t lhead = lsize ? lbounds[lbound_index] : sentinel;
+    pset_boundary_t rhead = rsize ? rbounds[rbound_index] : sentinel;
 
     //is this list on an upper bound or on a lower bound ?
-    bool lside = lbound_index % 2 != 0;
-    bool rside = rbound_index % 2 != 0;
+    bool lside = false;
+    bool rside = false;
 
-    //min of the two intervals 
+    //min of the two intervals
     pset_boundary_t head = (lhead < rhead) ? lhead : rhead;
 
     while (head < sentinel) {
+        // state of the region [head, next head[
         bool inleft = (head < lhead) == lside;
         bool inright = (head < rhead) == rside;
 
-        bool keep = operator(inleft, inright);
-
-        //Black magic implementation
-        if (keep ^ side) {
-            result->_boundaries[result->nb_boundary] = head;
-            result->nb_boundary +=1;
+        if (inleft && inright){
+            found |= PSET_COMMON;
+        } else if (inleft){
+            found |= PSET_LEFT_ONLY;
+        } else if (inright){
+            found |= PSET_RIGHT_ONLY;
+        }
 
-            side = !side;       // we chose a bound for this side
+        // we found a witness, no need to go further
+        if (found & stop_on){
+            break;
         }
 
         if (head == lhead) {
             lbound_index++;
 
-            if (lbound_index < lpset->nb_boundary) {
+            if (lbound_index < lsize) {
                 lside = lbound_index%2 != 0;
-                lhead = lpset->_boundaries[lbound_index];
+                lhead = lbounds[lbound_index];
             } else { // sentinel
                 lhead = sentinel;
                 lside = false;
@@ -182,144 +797,373 @@ merge(ProcSetObject* lpset,ProcSetObject* rpset, MergePredicate operator){
         }
         if (head == rhead) {
             rbound_index++;
-            if (rbound_index < rpset->nb_boundary) {
+            if (rbound_index < rsize) {
                 rside = rbound_index%2 != 0;
-                rhead = rpset->_boundaries[rbound_index];
+                rhead = rbounds[rbound_index];
             } else { // sentinel
                 rhead = sentinel;
                 rside = false;
             }
         }
 
-        head = (lhead < rhead) ? lhead : rhead;               
+        head = (lhead < rhead) ? lhead : rhead;
     }
 
-    // early termination if we had allocated the right amount of memory
-    if (result->nb_boundary == maxBound){
-        return (PyObject *) result;
-    }
+    return found;
+}
 
-    // we free the excess memory TODO: is  the +1 here usefull ?
-    pset_boundary_t* bounds = PyMem_Realloc(result->_boundaries, (result->nb_boundary + 1) * sizeof(pset_boundary_t));
+// relation_kernel on the boundaries of two procsets, without the GIL when they are big
+static int
+relation_sweep(ProcSetObject* lpset, ProcSetObject* rpset, int stop_on){
+    ProcSetObject * operands[2] = {lpset, rpset};
+    PyThreadState * state = pset_begin_nogil(operands, 2, lpset->nb_boundary + rpset->nb_boundary);
+    int found = relation_kernel(lpset->_boundaries, lpset->nb_boundary, rpset->_boundaries, rpset->nb_boundary, stop_on);
+    pset_end_nogil(state, operands, 2);
+    return found;
+}
 
-    // bounds will be null if realloc failed (but the previous pointer will remain valid, se we have to check)
-    if (bounds){
-        result->_boundaries = bounds;
+// an entry of the k-way merge heap: the current boundary of one of the lists
+typedef struct {
+    pset_boundary_t value;
+    Py_ssize_t list;
+} HeapEntry;
+
+// the number of lists a k-way merge can handle without allocating its state, see _merge_to_buffer
+#define PSET_KWAY_SCRATCH 32
+
+// restores the heap property below the entry at position pos
+static inline void
+_heap_sift_down(HeapEntry * heap, Py_ssize_t size, Py_ssize_t pos){
+    HeapEntry entry = heap[pos];
+    Py_ssize_t child;
+    while ((child = 2 * pos + 1) < size){
+        if (child + 1 < size && heap[child + 1].value < heap[child].value){
+            child++;
+        }
+        if (entry.value <= heap[child].value){
+            break;
+        }
+        heap[pos] = heap[child];
+        pos = child;
     }
-
-    return (PyObject *) result;
+    heap[pos] = entry;
 }
 
-// A method with the shared logic of the inplace functions
-static PyObject *
-_inplace_core(ProcSetObject * self, PyObject * other, InplaceType fonction){
-    // we get the result
-    PyObject * result = fonction(self, other);
-    
-    // you get no result when an error occures, so we check for errors
-    if (!result || Py_Is(result, Py_NotImplemented)){
-        return result;
+// K-WAY MERGE (Core function)
+// Applies operation to count procsets in a single pass: a min-heap holds the current boundary of
+// every list, and we count how many lists cover the current position. The predicate of the operation
+// tells from this coverage if the position is in the result, a boundary is written every time the
+// answer changes. out must have room for the boundaries of every operand, heap and positions for
+// count entries, positions being zeroed. Nothing is allocated, it can run without the GIL.
+// Returns the number of boundaries written in out.
+static Py_ssize_t
+kway_kernel(ProcSetObject *list[], Py_ssize_t count, const SetOperation * operation, pset_boundary_t * out,
+            HeapEntry * heap, Py_ssize_t * positions){
+
+    // the first boundary of every non empty list
+    Py_ssize_t heap_size = 0;
+    for (Py_ssize_t i = 0; i < count; i++){
+        if (list[i]->nb_boundary){
+            heap[heap_size].value = list[i]->_boundaries[0];
+            heap[heap_size].list = i;
+            heap_size++;
+        }
     }
-    
-    Py_ssize_t nb_elements = ((ProcSetObject * ) result)->nb_boundary;
-
-    // self is probably not the right size so we resize it
-    if (!pset_resize(self, nb_elements)){
-        return NULL;    // the error message is already set
+    for (Py_ssize_t i = heap_size / 2 - 1; i >= 0; i--){
+        _heap_sift_down(heap, heap_size, i);
     }
-    
-    // we copy every element of result in self
-    pset_copy((ProcSetObject * ) result, self, nb_elements);
 
-    // we set the right size for self
-    self->nb_boundary = nb_elements;
+    // number of lists inside an interval at the current position, and whether the first one is
+    Py_ssize_t coverage = 0;
+    bool in_first = false;
+    bool inside = false;
+    Py_ssize_t nb_boundary = 0;
 
-    
-    Py_DECREF(result);
-    Py_INCREF(self);        // it needs to return self for parity reason (would cause tests that uses "IS" to fail)
-    return (PyObject *) self;
-}
+    while (heap_size){
+        pset_boundary_t head = heap[0].value;
 
-// __bool__
-static int
-ProcSet_bool(ProcSetObject* self){
-    return self->nb_boundary != 0;
-}
+        // we consume every boundary equal to head
+        while (heap_size && heap[0].value == head){
+            Py_ssize_t current = heap[0].list;
+            Py_ssize_t pos = positions[current]++;
 
-// __or__ et |
-static PyObject*
-ProcSet_or(ProcSetObject* self, PyObject* other){
+            // lower bounds are at even positions
+            coverage += (pos % 2 == 0) ? 1 : -1;
+            if (current == 0){
+                in_first = pos % 2 == 0;
+            }
 
-    // other needs to be a procset, self will always be
-    if (!Py_IS_TYPE(other, &ProcSetType)){
-        Py_RETURN_NOTIMPLEMENTED;
-    }
+            if (pos + 1 < list[current]->nb_boundary){
+                heap[0].value = list[current]->_boundaries[pos + 1];
+            } else {
+                heap[0] = heap[--heap_size];
+            }
+            _heap_sift_down(heap, heap_size, 0);
+        }
 
-    // we call merge on the two objects and return the result
-    return merge(self, (ProcSetObject *) other, bitwiseUnion);
-}
+        if (inside != operation->nary(in_first, coverage, count)){
+            out[nb_boundary++] = head;
+            inside = !inside;
+        }
+    }
 
-// __ior__
-static PyObject *
-ProcSet_ior(ProcSetObject * self, PyObject* other){
-    return _inplace_core(self, other, ProcSet_or);
+    return nb_boundary;
 }
 
-// __and__ et &
-static PyObject*
-ProcSet_and(ProcSetObject* self, PyObject* other){
-
-    // other needs to be a procset, self will always be
-    if (!Py_IS_TYPE(other, &ProcSetType)){
-        Py_RETURN_NOTIMPLEMENTED;
+// Applies operation to count (>= 1) procsets, the result is written in a new buffer (*out) of *capacity boundaries
+// Returns the number of boundaries of the result, -1 if an error occured
+static Py_ssize_t
+_merge_to_buffer(ProcSetObject *list[], Py_ssize_t count, const SetOperation * operation, pset_boundary_t ** out, Py_ssize_t * capacity){
+    // the result cannot have more boundaries than its operands
+    Py_ssize_t maxBound = 0;
+    for (Py_ssize_t i = 0; i < count; i++){
+        maxBound += list[i]->nb_boundary;
     }
 
-    // we call merge on the two objects and return the result
-    return merge(self, (ProcSetObject *) other, bitwiseIntersection);
-}
+    // we always allocate something, an empty result is still a valid buffer
+    pset_boundary_t * buffer = (pset_boundary_t *) PyMem_Malloc((maxBound ? maxBound : 1) * sizeof(pset_boundary_t));
+    if (!buffer){
+        PyErr_NoMemory();
+        return -1;
+    }
 
-// __iand__
-static PyObject *
-ProcSet_iand(ProcSetObject * self, PyObject* other){
-    return _inplace_core(self, other, ProcSet_and);
-}
+    // the state of the k-way merge is allocated while we still hold the GIL, in a single scratch block:
+    // on the stack for up to PSET_KWAY_SCRATCH lists, the heap entries followed by the positions
+    HeapEntry heap_scratch[PSET_KWAY_SCRATCH];
+    Py_ssize_t positions_scratch[PSET_KWAY_SCRATCH];
+    HeapEntry * heap = heap_scratch;
+    Py_ssize_t * positions = positions_scratch;
+    if (count > PSET_KWAY_SCRATCH){
+        heap = (HeapEntry *) PyMem_Malloc(count * (sizeof(HeapEntry) + sizeof(Py_ssize_t)));
+        if (!heap){
+            PyMem_Free(buffer);
+            PyErr_NoMemory();
+            return -1;
+        }
+        positions = (Py_ssize_t *) (heap + count);
+    }
+    if (count > 2){
+        memset(positions, 0, count * sizeof(Py_ssize_t));
+    }
 
-// __sub__ et -
-static PyObject*
-ProcSet_sub(ProcSetObject* self, PyObject* other){
+    // the settings are read with the GIL, another thread may change them during the merge
+    Py_ssize_t nb_boundary;
+    Py_ssize_t ratio = gallop_ratio, threads = merge_threads;
+    PyThreadState * state = pset_begin_nogil(list, count, maxBound);
+    if (count == 1){
+        if (maxBound){
+            memcpy(buffer, list[0]->_boundaries, maxBound * sizeof(pset_boundary_t));
+        }
+        nb_boundary = maxBound;
+    } else if (count == 2){
+        // the processors are counted when the buffer is given to its procset
+        nb_boundary = _binary_merge(operation, list[0]->_boundaries, list[0]->nb_boundary, list[1]->_boundaries, list[1]->nb_boundary,
+                                    buffer, NULL, ratio, threads);
+    } else {
+        nb_boundary = kway_kernel(list, count, operation, buffer, heap, positions);
+    }
+    pset_end_nogil(state, list, count);
 
-    // other needs to be a procset, self will always be
-    if (!Py_IS_TYPE(other, &ProcSetType)){
-        Py_RETURN_NOTIMPLEMENTED;
+    if (heap != heap_scratch){
+        PyMem_Free(heap);
     }
 
-    // we call merge on the two objects and return the result
-    return merge(self, (ProcSetObject *) other, bitwiseDifference);
+    *out = buffer;
+    *capacity = maxBound;
+    return nb_boundary;
+}
+
+// Applies operation to count procsets and returns the result as a new procset
+// The result of a single operand is the operand itself
+static ProcSetObject *
+_kway_merge(ProcSetObject *list[], Py_ssize_t count, const SetOperation * operation){
+    #ifdef PSET_DEBUG
+    printf("_kway_merge -> count: %li\n", count);
+    #endif
+
+    if (count == 1){
+        return (ProcSetObject *) Py_NewRef(list[0]);
+    }
+
+    ProcSetObject * result = _pset_new(Py_TYPE(list[0]));
+    if (!result){
+        return NULL;
+    }
+
+    pset_boundary_t * buffer;
+    Py_ssize_t capacity;
+    Py_ssize_t nb_boundary = _merge_to_buffer(list, count, operation, &buffer, &capacity);
+    if (nb_boundary < 0){
+        Py_DECREF(result);
+        return NULL;
+    }
+
+    pset_replace_boundaries(result, buffer, nb_boundary, capacity);
+    pset_trim(result);
+    return result;
+}
+
+// Applies operation to count procsets and stores the result in target, which can be one of the operands
+// No intermediate procset is created.
+//
+// When target is the left operand of a two operand operation, the merge happens in the buffer of target:
+// its boundaries are moved at the end of its capacity, and the result is written from the start.
+// Every boundary written comes from a boundary already read, so the output never catches up with the
+// unread boundaries of target as long as the gap is at least the size of the other operand.
+// Otherwise the result is written in a new buffer which replaces the one of target. So are the results of
+// big merges, which run without the GIL: other threads must not see target while it is half written.
+static int
+_kway_merge_into(ProcSetObject * target, ProcSetObject *list[], Py_ssize_t count, const SetOperation * operation){
+    if (!pset_check_mutable(target)){
+        return 0;
+    }
+
+    if (count == 2 && list[0] == target && list[1] != target
+        && target->nb_boundary + list[1]->nb_boundary < PSET_NOGIL_THRESHOLD){
+        Py_ssize_t lsize = target->nb_boundary;
+        Py_ssize_t rsize = list[1]->nb_boundary;
+
+        // the capacity grows geometrically, a procset mutated again and again stops reallocating
+        if (!pset_reserve(target, lsize + rsize)){
+            return 0;
+        }
+
+        pset_boundary_t * lbounds = target->_boundaries + target->capacity - lsize;
+        memmove(lbounds, target->_boundaries, lsize * sizeof(pset_boundary_t));
+
+        target->nb_boundary = operation->binary(lbounds, lsize, list[1]->_boundaries, rsize, target->_boundaries, gallop_ratio);
+        target->length = pset_count_processors(target->_boundaries, target->nb_boundary);
+        pset_invalidate_cache(target);
+        return 1;
+    }
+
+    // target stays pinned until its boundaries are replaced: the other threads modifying it wait for
+    // this merge instead of having their modification overwritten by its result
+    target->pins++;
+    pset_boundary_t * buffer;
+    Py_ssize_t capacity;
+    Py_ssize_t nb_boundary = _merge_to_buffer(list, count, operation, &buffer, &capacity);
+    if (nb_boundary >= 0){
+        // the sweeps other threads started meanwhile still read the previous boundaries
+        pset_wait_pins(target, 1);
+    }
+    pset_unpin(target);
+    if (nb_boundary < 0){
+        return 0;
+    }
+
+    // another thread may have exported the boundaries of target while the merge ran without the GIL
+    if (target->exports > 0){
+        PyErr_SetString(PyExc_BufferError, "Existing exports of data: ProcSet cannot be modified");
+        PyMem_Free(buffer);
+        return 0;
+    }
+
+    pset_replace_boundaries(target, buffer, nb_boundary, capacity);
+    return 1;
+}
+
+// A method with the shared logic of the inplace functions
+static PyObject *
+_inplace_core(ProcSetObject * self, PyObject * other, const SetOperation * operation){
+    // other needs to be a procset, self will always be
+    if (!PSet_Check(other)){
+        Py_RETURN_NOTIMPLEMENTED;
+    }
+    if (!pset_check_mutable(self)){
+        return NULL;
+    }
+
+    // the result replaces the boundaries of self, no other procset is created
+    ProcSetObject * operands[2] = {self, (ProcSetObject *) other};
+    if (!_kway_merge_into(self, operands, 2, operation)){
+        return NULL;
+    }
+
+    Py_INCREF(self);        // it needs to return self for parity reason (would cause tests that uses "IS" to fail)
+    return (PyObject *) self;
+}
+
+// __bool__
+static int
+ProcSet_bool(ProcSetObject* self){
+    return self->nb_boundary != 0;
+}
+
+// __or__ et |
+static PyObject*
+ProcSet_or(ProcSetObject* self, PyObject* other){
+
+    // both operands need to be procsets, self is the right operand of a reflected operation
+    if (!PSet_Check(self) || !PSet_Check(other)){
+        Py_RETURN_NOTIMPLEMENTED;
+    }
+
+    // we call merge on the two objects and return the result
+    return merge(self, (ProcSetObject *) other, &setUnion);
+}
+
+// __ior__
+static PyObject *
+ProcSet_ior(ProcSetObject * self, PyObject* other){
+    return _inplace_core(self, other, &setUnion);
+}
+
+// __and__ et &
+static PyObject*
+ProcSet_and(ProcSetObject* self, PyObject* other){
+
+    // both operands need to be procsets, self is the right operand of a reflected operation
+    if (!PSet_Check(self) || !PSet_Check(other)){
+        Py_RETURN_NOTIMPLEMENTED;
+    }
+
+    // we call merge on the two objects and return the result
+    return merge(self, (ProcSetObject *) other, &setIntersection);
+}
+
+// __iand__
+static PyObject *
+ProcSet_iand(ProcSetObject * self, PyObject* other){
+    return _inplace_core(self, other, &setIntersection);
+}
+
+// __sub__ et -
+static PyObject*
+ProcSet_sub(ProcSetObject* self, PyObject* other){
+
+    // both operands need to be procsets, self is the right operand of a reflected operation
+    if (!PSet_Check(self) || !PSet_Check(other)){
+        Py_RETURN_NOTIMPLEMENTED;
+    }
+
+    // we call merge on the two objects and return the result
+    return merge(self, (ProcSetObject *) other, &setDifference);
 }
 
 // __isub__
 static PyObject *
 ProcSet_isub(ProcSetObject * self, PyObject* other){
-    return _inplace_core(self, other, ProcSet_sub);
+    return _inplace_core(self, other, &setDifference);
 }
 
 // __xor__ et ^
 static PyObject*
 ProcSet_xor(ProcSetObject* self, PyObject* other){
 
-    // other needs to be a procset, self will always be
-    if (!Py_IS_TYPE(other, &ProcSetType)){
+    // both operands need to be procsets, self is the right operand of a reflected operation
+    if (!PSet_Check(self) || !PSet_Check(other)){
         Py_RETURN_NOTIMPLEMENTED;
     }
 
     // we call merge on the two objects and return the result
-    return merge(self, (ProcSetObject *) other, bitwiseSymmetricDifference);
+    return merge(self, (ProcSetObject *) other, &setSymmetricDifference);
 }
 
 // __ixor__
 static PyObject *
 ProcSet_ixor(ProcSetObject * self, PyObject* other){
-    return _inplace_core(self, other, ProcSet_xor);
+    return _inplace_core(self, other, &setSymmetricDifference);
 }
 
 // repertoires des methodes 
@@ -335,35 +1179,6 @@ static PyNumberMethods ProcSet_number_methods = {
     .nb_inplace_or          = (binaryfunc) ProcSet_ior,
 };
 
-// merge de procset récursif DPR
-static ProcSetObject * _rec_merge(ProcSetObject *list[], Py_ssize_t lower, Py_ssize_t upper){
-    #ifdef PSET_DEBUG
-    printf("_rec_merge -> lower: %li, upper: %li, avg: %li\n", lower, upper, (lower + upper) >> 1);
-    #endif
-
-    if (lower == upper){
-        //on retourne le pset courant
-        //return (ProcSetObject *) ProcSet_copy(list[lower], NULL);
-        return (ProcSetObject *) Py_NewRef(list[lower]);
-    }
-    
-    // average
-    Py_ssize_t avg = (lower + upper) / 2;
-
-    // le procset de gauche 
-    ProcSetObject * left = _rec_merge(list, lower, avg);
-    // le pset de droite
-    ProcSetObject * right = _rec_merge(list, avg+1, upper);
-
-    // le resultat de leur union
-    ProcSetObject * result = (ProcSetObject *) merge(left, right, bitwiseUnion);
-
-    // on libère nos références
-    Py_DECREF(left);
-    Py_DECREF(right);
-    return result; 
-}
-
 // makes a procset from a number, ex: ProcSet(1)
 static ProcSetObject *
 _parse_integer(PyObject * arg){
@@ -371,16 +1186,14 @@ _parse_integer(PyObject * arg){
     pset_boundary_t lower = (pset_boundary_t) PyLong_AsLong(arg);
 
     // on alloue de la mémoire pour le pset
-    ProcSetObject * res = (ProcSetObject *) ProcSetType.tp_new(&ProcSetType, NULL, NULL);
+    ProcSetObject * res = _pset_new(&ProcSetType);
     if (!res){
         PyErr_NoMemory();
         return NULL;
     }
 
     // on alloue de la mémoire pour l'interval et on vérifie que tout va bien
-    res->_boundaries = (pset_boundary_t *) PyMem_Malloc(2 * sizeof(pset_boundary_t));
-    if (!res->_boundaries){
-        PyErr_NoMemory();
+    if (!pset_alloc_boundaries(res, 2)){
         ProcSetType.tp_dealloc((PyObject *) res);
         return NULL;
     }
@@ -390,6 +1203,7 @@ _parse_integer(PyObject * arg){
     res->_boundaries[1] = lower+1;
 
     res->nb_boundary = 2;
+    res->length = 1;
 
     #ifdef PSET_DEBUG
     printf("\t* parsed a pset from a single digit\n");
@@ -398,32 +1212,25 @@ _parse_integer(PyObject * arg){
     return res;
 }
 
-// makes a procset from a list, ex: ProcSet([]), ProcSet([1]), ProcSet([1,5])
+// makes a procset from a list, ex: ProcSet([1,5])
 static ProcSetObject *
 _parse_list(PyObject * arg){
     Py_ssize_t nbrOfelements = PySequence_Size(arg);
+    if (nbrOfelements < 0){
+        return NULL;
+    }
 
     // we check for the number of elements in the iterable
-    // Valide si:
-    //  - non vide
-    //  - pas plus de 2 elements
-    //  - pas un string
-    //  - pas un tuple de taille 1
-    if (nbrOfelements > 2 || strcmp(arg->ob_type->tp_name, "str") == 0 ||(strcmp(arg->ob_type->tp_name, "tuple") == 0 && nbrOfelements == 1)){
+    // Valid if:
+    //  - exactly 2 elements, any other count would leave an unpaired boundary
+    //  - not a string
+    if (nbrOfelements != 2 || PyUnicode_Check(arg)){
         PyErr_SetString(PyExc_TypeError, "Incompatible iterable, expected an iterable of exactly 2 int");
         return NULL;
     }
 
-    ProcSetObject * res = (ProcSetObject *) ProcSetType.tp_new(&ProcSetType, NULL, NULL);
-    if (!res || !nbrOfelements){
-        return res;
-    }
-
-    // on alloue de la mémoire pour l'interval et on vérifie que tout va bien
-    res->_boundaries = (pset_boundary_t *) PyMem_Malloc(nbrOfelements * sizeof(pset_boundary_t));
-    if (!res->_boundaries){
-        PyErr_NoMemory();
-        ProcSetType.tp_dealloc((PyObject *) res);
+    ProcSetObject * res = _pset_alloc(&ProcSetType, nbrOfelements);
+    if (!res){
         return NULL;
     }
 
@@ -433,9 +1240,11 @@ _parse_list(PyObject * arg){
     Py_ssize_t i = 0;
     bool outer = false;
 
-    while ((currentObject = PyIter_Next(iterator))){
-        if (!PyNumber_Check(currentObject)){
+    // the iteration is checked too, the length of the iterable may not match its items
+    while (iterator && (currentObject = PyIter_Next(iterator))){
+        if (i == 2 || !PyNumber_Check(currentObject)){
             PyErr_SetString(PyExc_TypeError, "Incompatible iterable, expected an iterable of exactly 2 int");
+            Py_DECREF(currentObject);
             break;
         }
         res->_boundaries[i] = (pset_boundary_t) PyLong_AsLong(currentObject) + (outer ? 1 : 0);
@@ -443,16 +1252,18 @@ _parse_list(PyObject * arg){
         i++;
         Py_DECREF(currentObject);
     }
+    Py_XDECREF(iterator);
 
-    Py_XDECREF(currentObject);
-    Py_DECREF(iterator);
-
+    if (!PyErr_Occurred() && i != 2){
+        PyErr_SetString(PyExc_TypeError, "Incompatible iterable, expected an iterable of exactly 2 int");
+    }
     if (PyErr_Occurred()){
-        ProcSetType.tp_dealloc((PyObject*) res);
+        Py_DECREF(res);
         return NULL;
     }
 
-    res->nb_boundary = nbrOfelements;
+    res->nb_boundary = 2;
+    res->length = res->_boundaries[1] - res->_boundaries[0];
     #ifdef PSET_DEBUG
     debug_printprocset(res, 2);
     #endif
@@ -468,7 +1279,7 @@ _pset_factory(PyObject * arg){
     } 
     
     // if it's a procset
-    if (Py_IS_TYPE(arg, &ProcSetType)){
+    if (PSet_Check(arg)){
         return ProcSet_copy((ProcSetObject *) arg, NULL);
     }
     
@@ -484,23 +1295,51 @@ _pset_factory(PyObject * arg){
     return NULL;    
 }
 
-// returns a single procset made with the given args
-static ProcSetObject*
-_get_pset_from_args(PyObject * args){
-    if (!args || Py_IsNone(args) || !PySequence_Check(args)){
-        PyErr_BadArgument(); // TODO: BETTER ERROR MESSAGE
-        return NULL;
+// gets the value of arg if it is a plain int and a valid processor, returns false for anything else
+static inline bool
+_exact_index(PyObject * arg, pset_boundary_t * value){
+    if (!PyLong_CheckExact(arg)){
+        return false;
     }
 
-    Py_ssize_t lengthOfArgs = PySequence_Size(args);
-    #ifdef PSET_DEBUG
-    printf("args : %p, size: %li\n", (void *) args, lengthOfArgs); // debug
-    #endif
+    int overflow;
+    long long v = PyLong_AsLongLongAndOverflow(arg, &overflow);
+    if (overflow || v < 0 || v >= MAX_BOUND_VALUE){
+        return false;       // left to _pset_factory
+    }
+    *value = (pset_boundary_t) v;
+    return true;
+}
 
-    // if no args were given (valid case)
-    if (!lengthOfArgs){    
-        return (ProcSetObject *) ProcSetType.tp_new(&ProcSetType, NULL, NULL);
+// gets the interval [*lower, *upper] of arg if it is a plain int or a (a, b) tuple of them with a <= b,
+// all of them valid processors, returns false for anything else
+static inline bool
+_exact_interval(PyObject * arg, pset_boundary_t * lower, pset_boundary_t * upper){
+    if (PyTuple_CheckExact(arg) && PyTuple_GET_SIZE(arg) == 2){
+        return _exact_index(PyTuple_GET_ITEM(arg, 0), lower) && _exact_index(PyTuple_GET_ITEM(arg, 1), upper)
+               && *lower <= *upper;
     }
+    if (!_exact_index(arg, lower)){
+        return false;
+    }
+    *upper = *lower;
+    return true;
+}
+
+// plain int and (a, b) arguments that are valid intervals can be gathered into a builder instead of
+// becoming a procset each, ex: ProcSet(*node_ids) or ProcSet(*intervals)
+static inline bool
+_gather_interval(PSetBuilder * points, PyObject * arg, pset_boundary_t * lower, pset_boundary_t * upper){
+    return points && _exact_interval(arg, lower, upper);
+}
+
+// returns a list with one procset per given arg, args being the nargs arguments of a call
+// if points is not NULL, the int and (a, b) args are pushed into it instead
+static PyObject*
+_get_psets_from_args(PyObject * const * args, Py_ssize_t nargs, PSetBuilder * points){
+    #ifdef PSET_DEBUG
+    printf("args : %p, size: %li\n", (void *) args, nargs); // debug
+    #endif
 
     // une liste de pointeurs vers des psets
     PyObject * list_pset = PyList_New(0);
@@ -508,148 +1347,244 @@ _get_pset_from_args(PyObject * args){
         return NULL;
     }
 
-    // an iterator on args (args is a list of objects)
-    PyObject * iterator = PyObject_GetIter(args);
-    
-    // if args did not return an iterator (iterator protocol)
-    if (!iterator){
-        PyErr_SetString(PyExc_Exception, "Could not iterate over given args");        // we set the error message
-        return NULL;
-    }
-
-    // the current item
-    PyObject * currentItem;
-
     // for every argument
-    while ((currentItem = PyIter_Next(iterator))) {
-        PyObject * currentPset = _pset_factory(currentItem);
+    for (Py_ssize_t i = 0; i < nargs; i++){
+        pset_boundary_t lower, upper;
+        if (_gather_interval(points, args[i], &lower, &upper)){
+            if (!pset_builder_push(points, lower, upper + 1)){
+                break;
+            }
+            continue;
+        }
 
-        if (!currentPset/*  || Py_NotImplemented == currentPset */){
-            //Py_XDECREF(currentPset);
+        PyObject * currentPset = _pset_factory(args[i]);
+        if (!currentPset){
             break;
         }
 
         // on ajoute le pset
-        PyList_Append(list_pset, currentPset);
+        int failed = PyList_Append(list_pset, currentPset);
         Py_DECREF(currentPset);
-        Py_DECREF(currentItem);             // we allow the current element to be gc'ed 
-    };
+        if (failed){
+            break;
+        }
+    }
 
-    // we free the now useless iterator (even if an error occured)
-    Py_DECREF(iterator);  
+    if (PyErr_Occurred()){
+        Py_DECREF(list_pset);
+        return NULL;
+    }
 
-    ProcSetObject* other = NULL;
-    if (!PyErr_Occurred()){
-        // aliases to make it easier to read
-        PyListObject * objectASList = (PyListObject *) list_pset;
+    return list_pset;
+}
 
-        // This code is accessing the PyObject* buffer inside a PyListObject. 
-        // This is the same buffer that is read when using PySequence_GetItem().
-        // I'm only reading from the buffer so this is only half of a hazard.
-        // This will change when I implement another merge algorithm.
-        ProcSetObject ** tableauDePset = (ProcSetObject **) objectASList->ob_item;
-        other = _rec_merge(tableauDePset, 0, lengthOfArgs-1);
+// the procset of a single argument of the constructor, for the common cases: ProcSet(int),
+// ProcSet((a, b)) and ProcSet(pset). Returns NULL without setting an error for anything else,
+// which is left to the generic path (as are invalid values, to get the same errors)
+static ProcSetObject *
+_parse_single_arg(PyObject * arg){
+    pset_boundary_t lower, upper;
+    if (PSet_Check(arg)){
+        return (ProcSetObject *) _pset_copy((ProcSetObject *) arg, &ProcSetType);
+    }
+    if (!_exact_interval(arg, &lower, &upper)){
+        return NULL;
     }
 
-    Py_XDECREF(currentItem);
-    Py_DECREF(list_pset);
+    // a single interval fits in the inline storage
+    ProcSetObject * res = _pset_new(&ProcSetType);
+    if (res && pset_alloc_boundaries(res, 2)){
+        res->_boundaries[0] = lower;
+        res->_boundaries[1] = upper + 1;
+        res->nb_boundary = 2;
+        res->length = (Py_ssize_t) upper + 1 - lower;
+        return res;
+    }
+    Py_XDECREF(res);
+    return NULL;
+}
+
+// returns the union of the procsets of list_pset and of the intervals gathered in points, which end up
+// in a single operand. list_pset and the boundaries of points are consumed
+static ProcSetObject *
+_gathered_union(PyObject * list_pset, PSetBuilder * points){
+    if (points->nb_boundary){
+        ProcSetObject * gathered = _pset_new(&ProcSetType);
+        if (!gathered){
+            pset_builder_release(points);
+            Py_DECREF(list_pset);
+            return NULL;
+        }
+        pset_builder_finish(points, gathered);
+        int failed = PyList_Append(list_pset, (PyObject *) gathered);
+        Py_DECREF(gathered);
+        if (failed){
+            Py_DECREF(list_pset);
+            return NULL;
+        }
+    }
+
+    // if there was nothing to merge (valid case)
+    if (!PyList_GET_SIZE(list_pset)){    
+        Py_DECREF(list_pset);
+        return _pset_new(&ProcSetType);
+    }
+
+    // aliases to make it easier to read
+    PyListObject * objectASList = (PyListObject *) list_pset;
+
+    // This code is accessing the PyObject* buffer inside a PyListObject. 
+    // This is the same buffer that is read when using PySequence_GetItem().
+    // I'm only reading from the buffer so this is only half of a hazard.
+    ProcSetObject ** tableauDePset = (ProcSetObject **) objectASList->ob_item;
+    ProcSetObject * other = _kway_merge(tableauDePset, PyList_GET_SIZE(list_pset), &setUnion);
 
+    Py_DECREF(list_pset);
     return other;
 }
 
+// returns a single procset made with the nargs given args
+static ProcSetObject*
+_get_pset_from_args(PyObject * const * args, Py_ssize_t nargs){
+    if (nargs == 0){
+        return _pset_new(&ProcSetType);
+    }
+    if (nargs == 1){
+        ProcSetObject * single = _parse_single_arg(args[0]);
+        if (single || PyErr_Occurred()){
+            return single;
+        }
+    }
+
+    PSetBuilder points = PSET_BUILDER_INIT;
+    PyObject * list_pset = _get_psets_from_args(args, nargs, &points);
+    if (!list_pset){
+        pset_builder_release(&points);
+        return NULL;
+    }
+
+    return _gathered_union(list_pset, &points);
+}
+
+// applies operation to self and every given arg, in a single pass
 static PyObject *
-_literals_core(ProcSetObject* self, PyObject *args, InplaceType function){
-    ProcSetObject * other = _get_pset_from_args(args);
-    if (!other){
+_literals_core(ProcSetObject* self, PyObject * const * args, Py_ssize_t nargs, const SetOperation * operation){
+    // the most common call, p.union(q): no list of operands, q is not copied
+    if (nargs == 1 && PSet_Check(args[0])){
+        return merge(self, (ProcSetObject *) args[0], operation);
+    }
+
+    PyObject * list_pset = _get_psets_from_args(args, nargs, NULL);
+    if (!list_pset){
+        return NULL;
+    }
+
+    // self is the first operand
+    if (PyList_Insert(list_pset, 0, (PyObject *) self) < 0){
+        Py_DECREF(list_pset);
         return NULL;
     }
-    PyObject * result = function(self, (PyObject * ) other);
 
-    ProcSetType.tp_dealloc((PyObject *) other);
+    PyObject * result;
+    if (PyList_GET_SIZE(list_pset) == 1){
+        // no other operand, the result is a copy of self
+        result = _pset_copy(self, Py_TYPE(self));
+    } else {
+        ProcSetObject ** operands = (ProcSetObject **) ((PyListObject *) list_pset)->ob_item;
+        result = (PyObject *) _kway_merge(operands, PyList_GET_SIZE(list_pset), operation);
+    }
+
+    Py_DECREF(list_pset);
     return result;
 }
 
 static PyObject *
-ProcSet_union(ProcSetObject *self, PyObject *args)
+ProcSet_union(ProcSetObject *self, PyObject * const * args, Py_ssize_t nargs)
 {
-    return _literals_core(self, args, ProcSet_or);
+    return _literals_core(self, args, nargs, &setUnion);
 }
 
 static PyObject *
-ProcSet_intersection(ProcSetObject *self, PyObject *args)
+ProcSet_intersection(ProcSetObject *self, PyObject * const * args, Py_ssize_t nargs)
 {
-    return _literals_core(self, args, ProcSet_and);
+    return _literals_core(self, args, nargs, &setIntersection);
 
 }
 
 static PyObject *
-ProcSet_difference(ProcSetObject *self, PyObject *args)
+ProcSet_difference(ProcSetObject *self, PyObject * const * args, Py_ssize_t nargs)
 {
-    return _literals_core(self, args, ProcSet_sub);
+    return _literals_core(self, args, nargs, &setDifference);
 }
 
 static PyObject *
-ProcSet_symmetricDifference(ProcSetObject *self, PyObject *args)
+ProcSet_symmetricDifference(ProcSetObject *self, PyObject * const * args, Py_ssize_t nargs)
 {
-    return _literals_core(self, args, ProcSet_xor);
+    return _literals_core(self, args, nargs, &setSymmetricDifference);
 
 }
 
 // factorisation des fonctions d'update
 static PyObject * 
-_update_core(ProcSetObject *self, PyObject *args, InplaceType UpdateType){
-        
-    // the previous function does the heavy lifting for that one
-    PyObject * result = UpdateType(self, args);
+_update_core(ProcSetObject *self, PyObject * const * args, Py_ssize_t nargs, const SetOperation * operation){
+    if (!pset_check_mutable(self)){
+        return NULL;
+    }
 
-    // you get no result when an error occures, so we check for errors
-    if (!result || Py_Is(result, Py_NotImplemented)){
-        return result;
+    // the most common call, p.update(q): no list of operands, q is not copied
+    if (nargs == 1 && PSet_Check(args[0])){
+        ProcSetObject * operands[2] = {self, (ProcSetObject *) args[0]};
+        if (!_kway_merge_into(self, operands, 2, operation)){
+            return NULL;
+        }
+        return Py_NewRef(self);
+    }
+
+    PyObject * list_pset = _get_psets_from_args(args, nargs, NULL);
+    if (!list_pset){
+        return NULL;
     }
-    
-    Py_ssize_t nb_elements = ((ProcSetObject * ) result)->nb_boundary;
 
-    // self is probably not the right size
-    if (!pset_resize(self, nb_elements)){
-        return NULL;    // the error message is already set
+    // self is the first operand
+    if (PyList_Insert(list_pset, 0, (PyObject *) self) < 0){
+        Py_DECREF(list_pset);
+        return NULL;
     }
-    
-    // we copy every element of result in self
-    pset_copy((ProcSetObject * ) result, self, nb_elements);
 
-    // we set the right size for self
-    self->nb_boundary = nb_elements;
+    // the result replaces the boundaries of self, no other procset is created
+    ProcSetObject ** operands = (ProcSetObject **) ((PyListObject *) list_pset)->ob_item;
+    int success = PyList_GET_SIZE(list_pset) == 1 || _kway_merge_into(self, operands, PyList_GET_SIZE(list_pset), operation);
+    Py_DECREF(list_pset);
+    if (!success){
+        return NULL;
+    }
 
-/*     // we return result as it's a copy of self and is not referrenced by anything
-    return result; */
-    
-    Py_DECREF(result);
     Py_INCREF(self);        // it needs to return self for parity
     return (PyObject *) self; 
 }
 
 // returns the intersection and updates self
 static PyObject *
-ProcSet_update(ProcSetObject *self, PyObject *args){
-    return _update_core(self, args, ProcSet_union);
+ProcSet_update(ProcSetObject *self, PyObject * const * args, Py_ssize_t nargs){
+    return _update_core(self, args, nargs, &setUnion);
 }
 
 // returns the intersection and updates self
 static PyObject *
-ProcSet_update_intersection(ProcSetObject *self, PyObject *args){
-    return _update_core(self, args, ProcSet_intersection);
+ProcSet_update_intersection(ProcSetObject *self, PyObject * const * args, Py_ssize_t nargs){
+    return _update_core(self, args, nargs, &setIntersection);
 }
 
 // returns the difference and updates self
 static PyObject *
-ProcSet_update_difference(ProcSetObject *self, PyObject *args){
-    return _update_core(self, args, ProcSet_difference);
+ProcSet_update_difference(ProcSetObject *self, PyObject * const * args, Py_ssize_t nargs){
+    return _update_core(self, args, nargs, &setDifference);
 }
 
 // returns the symetric difference and updates self
 static PyObject *
-ProcSet_update_symmetricDifference(ProcSetObject *self, PyObject *args){
-    return _update_core(self, args, ProcSet_symmetricDifference);
+ProcSet_update_symmetricDifference(ProcSetObject *self, PyObject * const * args, Py_ssize_t nargs){
+    return _update_core(self, args, nargs, &setSymmetricDifference);
 }
 
 
@@ -658,7 +1593,7 @@ ProcSet_update_symmetricDifference(ProcSetObject *self, PyObject *args){
 static PyObject*
 ProcSet_min(ProcSetObject *self, void* Py_UNUSED(v)){
     // if null
-    if (!self || !self->_boundaries){
+    if (!self || !self->nb_boundary){
         PyErr_SetString(PyExc_ValueError, "Empty ProcSet");
         return NULL;
     }
@@ -671,7 +1606,7 @@ ProcSet_min(ProcSetObject *self, void* Py_UNUSED(v)){
 static PyObject*
 ProcSet_max(ProcSetObject *self, void * Py_UNUSED(v)){
     // if null
-    if (!self || !self->_boundaries){
+    if (!self || !self->nb_boundary){
         PyErr_SetString(PyExc_ValueError, "Empty ProcSet");
         return NULL;
     }
@@ -685,6 +1620,7 @@ static PyGetSetDef ProcSet_getset[] = {
     //name, get, set, doc, additional
     {"min", (getter) ProcSet_min, NULL ,"The first processor in the ProcSet (in increasing order).", NULL},
     {"max", (getter) ProcSet_max, NULL ,"The last processor in the ProcSet (in increasing order).", NULL},
+    {"capacity", (getter) ProcSet_capacity, NULL ,"The number of intervals the ProcSet can hold without reallocating memory.", NULL},
     {NULL, NULL, NULL, NULL, NULL}
 };
 
@@ -708,11 +1644,18 @@ _pset_from_split(PyObject * split, PyObject *insep){
     else {
         PyObject * a = PyLong_FromUnicodeObject(PyList_GetItem(absplit, 0) ,10);    // +2
         PyObject * b = PyLong_FromUnicodeObject(PyList_GetItem(absplit, 1) ,10);
+        // a reversed interval is invalid, like in _from_str_fast
+        if (!PyErr_Occurred() && PyObject_RichCompareBool(b, a, Py_LT) == 1){
+            PyErr_SetNone(PyExc_ValueError);
+        }
         if (!PyErr_Occurred()){
             // setlist decrefs the old one for us and uses the given reference
             PyList_SetItem(absplit, 0, a);
             PyList_SetItem(absplit, 1, b);
             res = (PyObject *) _parse_list(absplit);
+        } else {
+            Py_XDECREF(a);
+            Py_XDECREF(b);
         }
     }
 
@@ -723,41 +1666,195 @@ _pset_from_split(PyObject * split, PyObject *insep){
     return res;
 }
 
-// from_str
-static PyObject *
-ProcSet_fromStr(PyObject * Py_UNUSED(class), PyObject* args, PyObject * kwds){
-    // valid : 0-1 2 -> (0,2)
-    // early termination if args is empty
-    if (PyTuple_Size(args) != 1){
-        PyErr_Format(PyExc_TypeError, "Expected 1 argument (got %li) !", PyTuple_Size(args));
-        return NULL;
+// pushes the interval of a split (a-b or a) into builder when its bounds are valid processors in order
+// returns 1 once it is pushed, 0 if an error occured, -1 if the split is left to _pset_from_split
+static int
+_push_split(PSetBuilder * builder, PyObject * split, PyObject * insep){
+    PyObject * absplit = PyUnicode_Split(split, insep, 1);      // +1
+    if (!absplit){
+        PyErr_Clear();
+        return -1;
     }
 
-    // +2 ref -> 2
-    PyObject * insep = PyUnicode_FromString("-");
-    PyObject * outsep = PyUnicode_FromString(" ");
-    //kwds may be null
-    if (kwds){
-        PyObject * _insep = PyDict_GetItemString(kwds, "insep");  // borrowed ref
-        if (_insep){
-            // -1 ref -> 1
-            Py_DECREF(insep);
-            // +1   -> 2
-            insep = Py_NewRef(_insep);
-        }
-
-        PyObject * _outsep = PyDict_GetItemString(kwds, "outsep"); //borrowed ref
-        if (_outsep){
-            // -1 ref ->1
-            Py_DECREF(outsep);
-            // +1 -> 2
-            outsep = Py_NewRef(_outsep);
-        }
+    // a-b --> [a, b] or a --> [a]
+    Py_ssize_t nb = PyList_GET_SIZE(absplit);
+    pset_boundary_t bounds[2];
+    bool valid = true;
+    for (Py_ssize_t i = 0; i < nb && valid; i++){
+        PyObject * value = PyLong_FromUnicodeObject(PyList_GET_ITEM(absplit, i), 10);     // +1
+        valid = value && _exact_index(value, &bounds[i]);
+        Py_XDECREF(value);      // -1
+    }
+    Py_DECREF(absplit);     // -1
 
+    if (!valid || bounds[nb - 1] < bounds[0]){
+        PyErr_Clear();
+        return -1;
     }
+    return pset_builder_push(builder, bounds[0], bounds[nb - 1] + 1);
+}
 
-    // v borrowed ref
-    PyObject * str = PyTuple_GetItem(args, 0);  // cannot be null since we check the size above
+// reads an ASCII decimal integer from *pos
+// returns false for anything but a plain run of digits (sign, spaces, '_', non ASCII digits ...)
+// and for values whose exclusive bound doesn't fit in a pset_boundary_t, they are left to the generic parser
+static inline Py_ALWAYS_INLINE bool
+_scan_uint(const char * str, Py_ssize_t len, Py_ssize_t * pos, pset_boundary_t * value){
+    Py_ssize_t i = *pos;
+    uint64_t v = 0;
+    if (i >= len || (unsigned char)(str[i] - '0') > 9){
+        return false;
+    }
+    do {
+        v = v * 10 + (uint64_t)(str[i] - '0');
+        if (v >= MAX_BOUND_VALUE){
+            return false;
+        }
+        i++;
+    } while (i < len && (unsigned char)(str[i] - '0') <= 9);
+    *pos = i;
+    *value = (pset_boundary_t) v;
+    return true;
+}
+
+static inline Py_ALWAYS_INLINE bool
+_match_sep(const char * str, Py_ssize_t len, Py_ssize_t pos, const char * sep, Py_ssize_t seplen){
+    return pos + seplen <= len && memcmp(str + pos, sep, seplen) == 0;
+}
+
+// Single pass parser over the UTF-8 buffer of the string: the boundaries are written straight into
+// the buffer of the result, without any list or intermediate ProcSet.
+// As long as the intervals come sorted and disjoint they are appended (contiguous ones are merged
+// on the fly), otherwise they are sorted and merged at the end.
+// Returns 1 with the result in *res, 0 if an error occured (exception set), and -1 if the string is
+// not in the simple format and must go through the generic parser.
+static int
+_from_str_fast(PyObject * string, PyObject * insep, PyObject * outsep, ProcSetObject ** res){
+    Py_ssize_t len, inlen, outlen;
+    const char * str = PyUnicode_AsUTF8AndSize(string, &len);
+    const char * in = PyUnicode_Check(insep) ? PyUnicode_AsUTF8AndSize(insep, &inlen) : NULL;
+    const char * out = PyUnicode_Check(outsep) ? PyUnicode_AsUTF8AndSize(outsep, &outlen) : NULL;
+    if (!str || !in || !out){
+        PyErr_Clear();
+        return -1;
+    }
+    // an empty separator, or one starting with a digit, would make the split ambiguous
+    if (!inlen || !outlen || (unsigned char)(in[0] - '0') <= 9 || (unsigned char)(out[0] - '0') <= 9){
+        return -1;
+    }
+    // the generic parser splits on outsep first, an outsep found inside insep would split the intervals
+    for (Py_ssize_t i = 0; i + outlen <= inlen; i++){
+        if (_match_sep(in, inlen, i, out, outlen)){
+            return -1;
+        }
+    }
+
+    // every interval takes at least one digit and a separator (but the last one)
+    Py_ssize_t max_bounds = 2 * ((len + outlen) / (1 + outlen));
+    ProcSetObject * pset = _pset_alloc(&ProcSetType, max_bounds);
+    if (!pset){
+        return 0;
+    }
+
+    pset_boundary_t * bounds = pset->_boundaries;
+    Py_ssize_t nb = 0, pos = 0;
+    bool sorted = true;
+    for (;;){
+        pset_boundary_t a, b;
+        Py_ssize_t start = pos;
+        if (!_scan_uint(str, len, &pos, &a)){
+            goto fallback;
+        }
+        b = a;
+        if (_match_sep(str, len, pos, in, inlen)){
+            pos += inlen;
+            if (!_scan_uint(str, len, &pos, &b)){
+                goto fallback;
+            }
+            if (b < a){
+                // a reversed interval is invalid, the message names the whole token
+                while (pos < len && !_match_sep(str, len, pos, out, outlen)){
+                    pos++;
+                }
+                PyObject * token = PyUnicode_DecodeUTF8(str + start, pos - start, NULL);
+                if (token){
+                    PyErr_Format(PyExc_ValueError, "Invalid interval format, parsed string is: '%U'", token);
+                    Py_DECREF(token);
+                }
+                Py_DECREF(pset);
+                return 0;
+            }
+        }
+
+        if (nb && a <= bounds[nb - 1]){
+            if (a == bounds[nb - 1]){
+                bounds[nb - 1] = b + 1;
+                goto next;
+            }
+            sorted = false;
+        }
+        bounds[nb++] = a;
+        bounds[nb++] = b + 1;
+
+    next:
+        if (pos == len){
+            break;
+        }
+        if (!_match_sep(str, len, pos, out, outlen)){
+            goto fallback;
+        }
+        pos += outlen;
+    }
+
+    if (!sorted){
+        nb = pset_sort_and_coalesce(bounds, nb);
+    }
+
+    pset->nb_boundary = nb;
+    pset->length = pset_count_processors(bounds, nb);
+    pset_trim(pset);
+    *res = pset;
+    return 1;
+
+fallback:
+    Py_DECREF(pset);
+    return -1;
+}
+
+// parses the string given to from_str, the result is a ProcSet
+static PyObject *
+_from_str(PyObject* args, PyObject * kwds){
+    // valid : 0-1 2 -> (0,2)
+    // early termination if args is empty
+    if (PyTuple_Size(args) != 1){
+        PyErr_Format(PyExc_TypeError, "Expected 1 argument (got %li) !", PyTuple_Size(args));
+        return NULL;
+    }
+
+    // +2 ref -> 2
+    PyObject * insep = PyUnicode_FromString("-");
+    PyObject * outsep = PyUnicode_FromString(" ");
+    //kwds may be null
+    if (kwds){
+        PyObject * _insep = PyDict_GetItemString(kwds, "insep");  // borrowed ref
+        if (_insep){
+            // -1 ref -> 1
+            Py_DECREF(insep);
+            // +1   -> 2
+            insep = Py_NewRef(_insep);
+        }
+
+        PyObject * _outsep = PyDict_GetItemString(kwds, "outsep"); //borrowed ref
+        if (_outsep){
+            // -1 ref ->1
+            Py_DECREF(outsep);
+            // +1 -> 2
+            outsep = Py_NewRef(_outsep);
+        }
+
+    }
+
+    // v borrowed ref
+    PyObject * str = PyTuple_GetItem(args, 0);  // cannot be null since we check the size above
     if (!PyUnicode_Check(str)){
         // -2 -> 0
         Py_DECREF(insep);
@@ -771,67 +1868,586 @@ ProcSet_fromStr(PyObject * Py_UNUSED(class), PyObject* args, PyObject * kwds){
     if (PyUnicode_GetLength(str) == 0){
         Py_DECREF(insep);
         Py_DECREF(outsep);
-        PyObject * pset = ProcSetType.tp_new(&ProcSetType, NULL, NULL);
-        return pset;        //will return NULL with an error set if new failed
+        return (PyObject *) _pset_new(&ProcSetType);        //will return NULL with an error set if new failed
     }
 
+    ProcSetObject * fast = NULL;
+    int status = _from_str_fast(str, insep, outsep, &fast);
+    if (status >= 0){
+        Py_DECREF(insep);
+        Py_DECREF(outsep);
+        return (PyObject *) fast;      // NULL with an error set if status == 0
+    }
+
+    // not the simple format (spaces, '_', unusual separators ...) or invalid:
+    // the generic parser handles it, and builds the error messages
+
     // +1 ref -> 3
     PyObject * list_str = PyUnicode_Split(str, outsep, -1);
     Py_DECREF(outsep); // -1 -> 2
     // a of procset
     // +1 -> 3
-    PyObject * list_pset = PyList_New(0);
+    PyObject * list_pset = list_str ? PyList_New(0) : NULL;
     if (!list_pset){
         // error set above
+        Py_XDECREF(list_str);
+        Py_DECREF(insep);
         return NULL;
     }
 
-    // On va parser chaque split
-    // +1 ref -> 3
-    PyObject * iterator = PyObject_GetIter(list_str);
-    PyObject * currentSplit;
+    // the valid intervals are gathered in a single scratch buffer which becomes the buffer of the result,
+    // only the other splits are parsed into a procset each, to get the same results and errors
+    PSetBuilder points = PSET_BUILDER_INIT;
+    for (Py_ssize_t i = 0; i < PyList_GET_SIZE(list_str); i++){
+        PyObject * currentSplit = PyList_GET_ITEM(list_str, i);     // borrowed ref
+        int pushed = _push_split(&points, currentSplit, insep);
+        if (!pushed){
+            break;
+        }
+        if (pushed > 0){
+            continue;
+        }
 
-    // +1 ref -> 5
-    while ((currentSplit = PyIter_Next(iterator))){
-        // +1 -> 6
+        // +1 -> 4
         PyObject * parsed_pset = _pset_from_split(currentSplit, insep);
         if (!parsed_pset){
             break;
         }
 
-        PyList_Append(list_pset, parsed_pset);  // creates a new ref 
-        // -1 -> 5
+        int failed = PyList_Append(list_pset, parsed_pset);  // creates a new ref 
+        // -1 -> 3
         Py_DECREF(parsed_pset);
-        // -1 ref -> 4
-        Py_DECREF(currentSplit);
+        if (failed){
+            break;
+        }
     }
-    // -1 ref -> 3
-    Py_DECREF(iterator);
 
     // -2 -> 1
     Py_DECREF(list_str);
     Py_DECREF(insep);
 
     if (PyErr_Occurred()){
-        // -2 -> 0
-        Py_XDECREF(currentSplit);
+        // -1 -> 0
+        pset_builder_release(&points);
         Py_DECREF(list_pset);
         return NULL;
     }
 
-    // aliases to make it easier to read
-    PyListObject * objectASList = (PyListObject *) list_pset;
+    return (PyObject *) _gathered_union(list_pset, &points);
+}
 
-    // This code is accessing the PyObject* buffer inside a PyListObject. 
-    // This is the same buffer that is read when using PySequence_GetItem().
-    // I'm only reading from the buffer so this is only half of a hazard.
-    // This will change when I implement another merge algorithm.
-    ProcSetObject ** tableau_psets = (ProcSetObject **) objectASList->ob_item;
-    PyObject * res = (PyObject *) _rec_merge(tableau_psets, 0, PyList_Size(list_pset)-1);
-    Py_DECREF(list_pset);
-    return res;
+// from_str
+static PyObject *
+ProcSet_fromStr(PyObject * class, PyObject* args, PyObject * kwds){
+    return (PyObject *) _pset_cast((ProcSetObject *) _from_str(args, kwds), (PyTypeObject *) class);
+}
+
+// converts a python integer into a processor index, its exclusive bound must fit in a pset_boundary_t
+static int
+_index_from_object(PyObject * item, pset_boundary_t * value){
+    PyObject * index = PyLong_CheckExact(item) ? Py_NewRef(item) : PyNumber_Index(item);
+    if (!index){
+        return 0;
+    }
+
+    int overflow;
+    long long v = PyLong_AsLongLongAndOverflow(index, &overflow);
+    Py_DECREF(index);
+    if (v == -1 && PyErr_Occurred()){
+        return 0;
+    }
+    if (overflow || v < 0 || v >= MAX_BOUND_VALUE){
+        PyErr_Format(PyExc_ValueError, "Invalid processor index %R, expected 0 <= index < %u", item, MAX_BOUND_VALUE);
+        return 0;
+    }
+
+    *value = (pset_boundary_t) v;
+    return 1;
+}
+
+// a range is pushed as a single interval when its step is 1 or -1, without going through its elements
+static int
+_push_range(PSetBuilder * builder, PyObject * range){
+    Py_ssize_t size = PyObject_Size(range);
+    if (size <= 0){
+        return size == 0;
+    }
+
+    pset_boundary_t first, last;
+    PyObject * item = PySequence_GetItem(range, 0);
+    int ok = item && _index_from_object(item, &first);
+    Py_XDECREF(item);
+    if (!ok){
+        return 0;
+    }
+    item = PySequence_GetItem(range, size - 1);
+    ok = item && _index_from_object(item, &last);
+    Py_XDECREF(item);
+    if (!ok){
+        return 0;
+    }
+
+    // both ends are valid indexes so the step fits in a long long
+    long long step = size > 1 ? ((long long) last - (long long) first) / (size - 1) : 1;
+    if (step == 1 || step == -1){
+        return first <= last ? pset_builder_push(builder, first, last + 1) : pset_builder_push(builder, last, first + 1);
+    }
+
+    for (Py_ssize_t i = 0; i < size; i++){
+        pset_boundary_t v = (pset_boundary_t) (first + i * step);
+        if (!pset_builder_push(builder, v, v + 1)){
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static inline bool
+_valid_index(bool negative, unsigned long long value){
+    return !negative && value < MAX_BOUND_VALUE;
+}
+
+// the native integer formats of the struct module, with the test telling if a value v is negative
+#define FOR_EACH_INT_FORMAT(X)              \
+    X('b', signed char, v < 0)              \
+    X('B', unsigned char, false)            \
+    X('h', short, v < 0)                    \
+    X('H', unsigned short, false)           \
+    X('i', int, v < 0)                      \
+    X('I', unsigned int, false)             \
+    X('l', long, v < 0)                     \
+    X('L', unsigned long, false)            \
+    X('q', long long, v < 0)                \
+    X('Q', unsigned long long, false)       \
+    X('n', Py_ssize_t, v < 0)               \
+    X('N', size_t, false)
+
+#define PUSH_BUFFER_OF(ctype, negative)                                                             \
+    for (Py_ssize_t i = 0; i < count; i++){                                                         \
+        ctype v;                                                                                    \
+        memcpy(&v, data + i * sizeof(ctype), sizeof(ctype));                                       \
+        if (!_valid_index(negative, (unsigned long long) v)){                                       \
+            PyErr_Format(PyExc_ValueError, "Invalid processor index %lld, expected 0 <= index < %u",\
+                         (long long) v, MAX_BOUND_VALUE);                                           \
+            return 0;                                                                               \
+        }                                                                                           \
+        if (!pset_builder_push(builder, (pset_boundary_t) v, (pset_boundary_t) v + 1)){             \
+            return 0;                                                                               \
+        }                                                                                           \
+    }                                                                                               \
+    return 1;
+
+// reads a native integer array exposed through the buffer protocol, without boxing its elements
+static int
+_push_buffer_items(PSetBuilder * builder, const Py_buffer * view){
+    const char * format = view->format ? view->format : "B";
+    if (*format == '@'){
+        format++;
+    }
+
+    const char * data = view->buf;
+    Py_ssize_t count = view->itemsize ? view->len / view->itemsize : 0;
+    if (format[0] && !format[1]){
+        switch (format[0]){
+            #define PUSH_CASE(code, ctype, negative) case code: PUSH_BUFFER_OF(ctype, negative)
+            FOR_EACH_INT_FORMAT(PUSH_CASE)
+            #undef PUSH_CASE
+        }
+    }
+
+    PyErr_Format(PyExc_TypeError, "Expected a buffer of native integers, got format '%s'", view->format);
+    return 0;
+}
+
+#undef PUSH_BUFFER_OF
+
+static int
+_push_buffer(PSetBuilder * builder, PyObject * obj){
+    Py_buffer view;
+    if (PyObject_GetBuffer(obj, &view, PyBUF_FORMAT | PyBUF_C_CONTIGUOUS) < 0){
+        return 0;
+    }
+    int ok = _push_buffer_items(builder, &view);
+    PyBuffer_Release(&view);
+    return ok;
+}
+
+// pushes every processor index of an iterable of integers, a range or an integer buffer
+static int
+_push_iterable(PSetBuilder * builder, PyObject * iterable){
+    if (PyRange_Check(iterable)){
+        return _push_range(builder, iterable);
+    }
+    // a procset exposes its boundaries through the buffer protocol, not its processors
+    if (PSet_Check(iterable)){
+        ProcSetObject * pset = (ProcSetObject *) iterable;
+        for (Py_ssize_t i = 0; i < pset->nb_boundary; i += 2){
+            if (!pset_builder_push(builder, pset->_boundaries[i], pset->_boundaries[i+1])){
+                return 0;
+            }
+        }
+        return 1;
+    }
+    if (PyObject_CheckBuffer(iterable)){
+        return _push_buffer(builder, iterable);
+    }
+
+    PyObject * items = PySequence_Fast(iterable, "from_iterable() argument must be an iterable of int");
+    if (!items){
+        return 0;
+    }
+
+    Py_ssize_t size = PySequence_Fast_GET_SIZE(items);
+    PyObject ** array = PySequence_Fast_ITEMS(items);
+    for (Py_ssize_t i = 0; i < size; i++){
+        pset_boundary_t v;
+        if (!_index_from_object(array[i], &v) || !pset_builder_push(builder, v, v + 1)){
+            Py_DECREF(items);
+            return 0;
+        }
+    }
+
+    Py_DECREF(items);
+    return 1;
+}
+
+// from_iterable, from_indices
+static PyObject *
+ProcSet_fromIterable(PyObject * class, PyObject * iterable){
+    PSetBuilder builder = PSET_BUILDER_INIT;
+    if (!_push_iterable(&builder, iterable)){
+        pset_builder_release(&builder);
+        return NULL;
+    }
+
+    PyTypeObject * type = (PyTypeObject *) class;
+    ProcSetObject * res = _pset_new(type);
+    if (!res){
+        pset_builder_release(&builder);
+        return NULL;
+    }
+
+    pset_builder_finish(&builder, res);
+    return (PyObject *) res;
 }
 
+static inline bool
+_valid_boundary(bool negative, unsigned long long value){
+    return !negative && value <= MAX_BOUND_VALUE;
+}
+
+#define COPY_BUFFER_OF(ctype, negative)                                                             \
+    for (Py_ssize_t i = 0; i < count; i++){                                                         \
+        ctype v;                                                                                    \
+        memcpy(&v, data + i * sizeof(ctype), sizeof(ctype));                                       \
+        if (!_valid_boundary(negative, (unsigned long long) v)){                                    \
+            PyErr_Format(PyExc_ValueError, "Invalid boundary %lld, expected 0 <= boundary <= %u",   \
+                         (long long) v, MAX_BOUND_VALUE);                                           \
+            return 0;                                                                               \
+        }                                                                                           \
+        bounds[i] = (pset_boundary_t) v;                                                            \
+    }                                                                                               \
+    return 1;
+
+// copies the count integers of a native integer buffer into bounds
+static int
+_copy_buffer_items(pset_boundary_t * bounds, const Py_buffer * view, Py_ssize_t count){
+    const char * format = view->format ? view->format : "B";
+    if (*format == '@'){
+        format++;
+    }
+
+    const char * data = view->buf;
+    if (format[0] && !format[1]){
+        // the layout of a procset buffer, a plain copy is enough
+        if ((format[0] == 'I' || format[0] == 'L') && view->itemsize == sizeof(pset_boundary_t)){
+            memcpy(bounds, data, count * sizeof(pset_boundary_t));
+            return 1;
+        }
+
+        switch (format[0]){
+            #define COPY_CASE(code, ctype, negative) case code: COPY_BUFFER_OF(ctype, negative)
+            FOR_EACH_INT_FORMAT(COPY_CASE)
+            #undef COPY_CASE
+        }
+    }
+
+    PyErr_Format(PyExc_TypeError, "Expected a buffer of native integers, got format '%s'", view->format);
+    return 0;
+}
+
+#undef COPY_BUFFER_OF
+
+// from_boundaries: the inverse of the buffer protocol, builds a procset from its half-open boundaries
+// the boundaries are copied once, then checked to be strictly increasing in a single pass
+static PyObject *
+ProcSet_fromBoundaries(PyObject * class, PyObject * obj){
+    Py_buffer view;
+    if (PyObject_GetBuffer(obj, &view, PyBUF_FORMAT | PyBUF_C_CONTIGUOUS) < 0){
+        return NULL;
+    }
+
+    Py_ssize_t count = view.itemsize ? view.len / view.itemsize : 0;
+    if (count % 2){
+        PyErr_Format(PyExc_ValueError, "Invalid boundaries, expected an even number of values (got %zd)", count);
+        PyBuffer_Release(&view);
+        return NULL;
+    }
+
+    PyTypeObject * type = (PyTypeObject *) class;
+    ProcSetObject * res = count ? _pset_alloc(type, count) : _pset_new(type);
+    if (!res){
+        PyBuffer_Release(&view);
+        return NULL;
+    }
+
+    int copied = !count || _copy_buffer_items(res->_boundaries, &view, count);
+    PyBuffer_Release(&view);
+    if (!copied){
+        Py_DECREF(res);
+        return NULL;
+    }
+
+    const pset_boundary_t * bounds = res->_boundaries;
+    Py_ssize_t length = 0;
+    for (Py_ssize_t i = 0; i < count; i += 2){
+        // a < b, and b < the next a, touching intervals must have been merged
+        if (bounds[i] >= bounds[i+1] || (i + 2 < count && bounds[i+1] >= bounds[i+2])){
+            Py_ssize_t at = bounds[i] >= bounds[i+1] ? i : i + 1;
+            PyErr_Format(PyExc_ValueError, "Invalid boundaries, expected strictly increasing values (%u at %zd is followed by %u)",
+                         bounds[at], at, bounds[at + 1]);
+            Py_DECREF(res);
+            return NULL;
+        }
+        length += bounds[i+1] - bounds[i];
+    }
+
+    res->nb_boundary = count;
+    res->length = length;
+    return (PyObject *) res;
+}
+
+// Binary encoding used by to_bytes/from_bytes and pickle:
+//   varint(nb_boundary) varint(b0) varint(b1 - b0 - 1) ... varint(bn - bn-1 - 1)
+// the boundaries are strictly increasing so every delta is >= 1, intervals of a few thousand
+// processors need 2 bytes per boundary instead of the 4 of the raw array
+static inline int
+_varint_size(uint64_t value){
+    int size = 1;
+    while (value >= 0x80){
+        value >>= 7;
+        size++;
+    }
+    return size;
+}
+
+static inline unsigned char *
+_varint_write(unsigned char * dst, uint64_t value){
+    while (value >= 0x80){
+        *dst++ = (unsigned char) (value | 0x80);
+        value >>= 7;
+    }
+    *dst++ = (unsigned char) value;
+    return dst;
+}
+
+// reads a varint of at most max_value, returns NULL if it is truncated or too big
+static inline const unsigned char *
+_varint_read(const unsigned char * src, const unsigned char * end, uint64_t max_value, uint64_t * value){
+    uint64_t result = 0;
+    for (int shift = 0; src < end && shift < 64; shift += 7){
+        unsigned char byte = *src++;
+        result |= (uint64_t) (byte & 0x7f) << shift;
+        if (!(byte & 0x80)){
+            if (result > max_value){
+                return NULL;
+            }
+            *value = result;
+            return src;
+        }
+    }
+    return NULL;
+}
+
+static inline uint64_t
+_encoded_delta(const pset_boundary_t * bounds, Py_ssize_t i){
+    return i ? (uint64_t) (bounds[i] - bounds[i-1] - 1) : bounds[0];
+}
+
+// to_bytes
+static PyObject *
+ProcSet_toBytes(ProcSetObject *self, PyObject *Py_UNUSED(args)){
+    const pset_boundary_t * bounds = self->_boundaries;
+    Py_ssize_t nb = self->nb_boundary;
+
+    // the exact size first, the bytes object is written in place
+    Py_ssize_t size = _varint_size(nb);
+    for (Py_ssize_t i = 0; i < nb; i++){
+        size += _varint_size(_encoded_delta(bounds, i));
+    }
+
+    PyObject * result = PyBytes_FromStringAndSize(NULL, size);
+    if (!result){
+        return NULL;
+    }
+
+    unsigned char * p = (unsigned char *) PyBytes_AS_STRING(result);
+    p = _varint_write(p, nb);
+    for (Py_ssize_t i = 0; i < nb; i++){
+        p = _varint_write(p, _encoded_delta(bounds, i));
+    }
+    return result;
+}
+
+// decodes the output of to_bytes into the boundaries of pset, which must not have any yet
+static int
+_decode_into(ProcSetObject * pset, PyObject * data){
+    Py_buffer view;
+    if (PyObject_GetBuffer(data, &view, PyBUF_SIMPLE) < 0){
+        return 0;
+    }
+
+    const unsigned char * src = view.buf;
+    const unsigned char * end = src + view.len;
+    uint64_t nb;
+
+    // every boundary takes at least one byte, a corrupted count can't trigger a huge allocation
+    src = _varint_read(src, end, (uint64_t) (end - src), &nb);
+    if (!src || nb % 2){
+        goto invalid;
+    }
+    if (nb && !pset_alloc_boundaries(pset, (Py_ssize_t) nb)){
+        PyBuffer_Release(&view);
+        return 0;
+    }
+
+    uint64_t previous = 0;
+    Py_ssize_t length = 0;
+    for (Py_ssize_t i = 0; i < (Py_ssize_t) nb; i++){
+        // the next boundary must not go past MAX_BOUND_VALUE
+        if (i && previous == MAX_BOUND_VALUE){
+            goto invalid;
+        }
+        uint64_t delta;
+        uint64_t max_delta = i ? MAX_BOUND_VALUE - previous - 1 : MAX_BOUND_VALUE;
+        src = _varint_read(src, end, max_delta, &delta);
+        if (!src){
+            goto invalid;
+        }
+        previous = i ? previous + delta + 1 : delta;
+        pset->_boundaries[i] = (pset_boundary_t) previous;
+        if (i % 2){
+            length += pset->_boundaries[i] - pset->_boundaries[i-1];
+        }
+    }
+    if (src != end){
+        goto invalid;
+    }
+
+    PyBuffer_Release(&view);
+    pset->nb_boundary = (Py_ssize_t) nb;
+    pset->length = length;
+    pset_invalidate_cache(pset);
+    return 1;
+
+invalid:
+    PyBuffer_Release(&view);
+    pset_free_boundaries(pset);
+    PyErr_SetString(PyExc_ValueError, "Invalid ProcSet encoding");
+    return 0;
+}
+
+// from_bytes
+static PyObject *
+ProcSet_fromBytes(PyObject * class, PyObject * data){
+    PyTypeObject * type = (PyTypeObject *) class;
+    ProcSetObject * res = _pset_new(type);
+    if (!res){
+        return NULL;
+    }
+
+    if (!_decode_into(res, data)){
+        Py_DECREF(res);
+        return NULL;
+    }
+    return (PyObject *) res;
+}
+
+// __reduce__: ProcSet() followed by __setstate__(to_bytes())
+// an immutable FrozenProcSet is rebuilt by from_bytes(to_bytes()) instead
+static PyObject *
+ProcSet_reduce(ProcSetObject *self, PyObject *Py_UNUSED(args)){
+    PyObject * state = ProcSet_toBytes(self, NULL);
+    if (!state){
+        return NULL;
+    }
+
+    if (FrozenPSet_Check(self)){
+        PyObject * from_bytes = PyObject_GetAttrString((PyObject *) Py_TYPE(self), "from_bytes");
+        if (!from_bytes){
+            Py_DECREF(state);
+            return NULL;
+        }
+        return Py_BuildValue("(N(N))", from_bytes, state);
+    }
+    return Py_BuildValue("(O()N)", (PyObject *) Py_TYPE(self), state);
+}
+
+// __setstate__
+static PyObject *
+ProcSet_setstate(ProcSetObject *self, PyObject *state){
+    // the previous boundaries are only released once the new ones are valid
+    ProcSetObject * decoded = _pset_new(&ProcSetType);
+    if (!decoded){
+        return NULL;
+    }
+    if (!_decode_into(decoded, state) || !pset_check_mutable(self)){
+        Py_DECREF(decoded);
+        return NULL;
+    }
+
+    pset_steal_boundaries(self, decoded);
+    Py_DECREF(decoded);
+    Py_RETURN_NONE;
+}
+
+// buffer protocol: a read-only view on the boundaries, as a 1 dimension array of uint32
+// the procset refuses to be modified until every view is released
+static int
+ProcSet_getbuffer(ProcSetObject *self, Py_buffer *view, int flags){
+    if (flags & PyBUF_WRITABLE){
+        PyErr_SetString(PyExc_BufferError, "ProcSet buffers are read-only");
+        view->obj = NULL;
+        return -1;
+    }
+
+    view->obj = Py_NewRef(self);
+    view->buf = self->_boundaries ? self->_boundaries : self->_inline;     // never NULL, even if empty
+    view->len = self->nb_boundary * sizeof(pset_boundary_t);
+    view->readonly = 1;
+    view->itemsize = sizeof(pset_boundary_t);
+    view->format = (flags & PyBUF_FORMAT) ? "I" : NULL;
+    view->ndim = 1;
+    // nb_boundary can't change while the view is alive
+    view->shape = (flags & PyBUF_ND) == PyBUF_ND ? &self->nb_boundary : NULL;
+    view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? &view->itemsize : NULL;
+    view->suboffsets = NULL;
+    view->internal = NULL;
+
+    self->exports++;
+    return 0;
+}
+
+static void
+ProcSet_releasebuffer(ProcSetObject *self, Py_buffer *Py_UNUSED(view)){
+    self->exports--;
+}
+
+static PyBufferProcs ProcSetBufferMethods = {
+    .bf_getbuffer = (getbufferproc) ProcSet_getbuffer,
+    .bf_releasebuffer = (releasebufferproc) ProcSet_releasebuffer,
+};
+
 // Deallocation method
 static void 
 ProcSet_dealloc(ProcSetObject *self)
@@ -841,9 +2457,17 @@ ProcSet_dealloc(ProcSetObject *self)
     printf("Calling dealloc on ProcSetObject @%p \n", (void * )self);
     #endif
 
+    PyMem_Free(self->_prefix);
+    self->_prefix = NULL;
+
+    // the procset and its buffer may be reused by the next allocations
+    if (_freelist_push(self)){
+        return;
+    }
+
     // We free the memory allocated for the boundaries
     // using the integrated py function
-    PyMem_Free(self->_boundaries);
+    pset_free_boundaries(self);
 
     // we call the free function of the type
     Py_TYPE((PyObject *)self)->tp_free((PyObject *) self);
@@ -854,13 +2478,9 @@ ProcSet_dealloc(ProcSetObject *self)
 static PyObject * 
 ProcSet_new(PyTypeObject *type, PyObject *Py_UNUSED(args), PyObject *Py_UNUSED(kwds))
 {
-    ProcSetObject *self;
-    
-    // we allocate memory for our new object using its type's allocator (the default one in this case)
-    self = (ProcSetObject *) type->tp_alloc(type, 0);
-
+    // we allocate memory for our new object, from the free list or with its type's allocator
     // nothing to init because the object is mutable and the integer's default value is not null
-    return (PyObject *) self;
+    return (PyObject *) _pset_new(type);
 }
 
 // init: initialization function, called after new
@@ -872,66 +2492,210 @@ ProcSet_init(ProcSetObject *self, PyObject *args, PyObject *Py_UNUSED(kwds))
     printf("Calling init for pset @%p\n", (void *) self);
     #endif
 
-    ProcSetObject * other = _get_pset_from_args(args);
+    // the arguments are parsed first, it may run Python code and release the GIL
+    ProcSetObject * other = _get_pset_from_args(PySequence_Fast_ITEMS(args), PyTuple_GET_SIZE(args));
     if (!other){
         return -1;
     }
+    if (!pset_check_mutable(self)){
+        Py_DECREF(other);
+        return -1;
+    }
 
-    self->_boundaries = other->_boundaries;
-    self->nb_boundary = other->nb_boundary;
+    // __init__ may be called again on an existing procset, its previous boundaries are released
+    // other is left empty, dealloc won't release the boundaries we took
+    pset_steal_boundaries(self, other);
 
-    other->_boundaries = NULL;      // we need to change it because dealloc will kill it
     Py_DECREF(other);   //non null so no X
     return 0;
 }
 
+// vectorcall: ProcSet(...) and FrozenProcSet(...) build the procset straight from the arguments,
+// without a tuple of arguments nor the calls to __new__ and __init__. Like them, it ignores keyword arguments.
+// tp_vectorcall is not inherited, subclasses still go through __new__ and __init__
+static PyObject *
+ProcSet_vectorcall(PyObject * type, PyObject * const * args, size_t nargsf, PyObject * Py_UNUSED(kwnames)){
+    Py_ssize_t nargs = PyVectorcall_NARGS(nargsf);
+
+    // like frozenset, FrozenProcSet(frozen) is frozen itself
+    if (type == (PyObject *) &FrozenProcSetType && nargs == 1 && Py_IS_TYPE(args[0], &FrozenProcSetType)){
+        return Py_NewRef(args[0]);
+    }
+
+    return (PyObject *) _pset_cast(_get_pset_from_args(args, nargs), (PyTypeObject *) type);
+}
+
+
 
+// Text rendering: every representation (__str__, __format__, __repr__) is written straight into a
+// single buffer of the exact size, then turned into a str once.
+typedef struct {
+    const char * str;
+    Py_ssize_t len;
+} StrPiece;
+
+#define STR_PIECE(literal) {literal, sizeof(literal) - 1}
+
+// a-b   -> prefix a open? insep b close? outsep ... suffix
+typedef struct {
+    StrPiece prefix;
+    StrPiece open;      // before an interval of more than one element
+    StrPiece insep;
+    StrPiece close;     // after an interval of more than one element
+    StrPiece outsep;
+    StrPiece suffix;
+} RenderStyle;
+
+static const RenderStyle strStyle = {
+    STR_PIECE(""), STR_PIECE(""), STR_PIECE("-"), STR_PIECE(""), STR_PIECE(" "), STR_PIECE(""),
+};
+
+static const RenderStyle reprStyle = {
+    STR_PIECE("ProcSet("), STR_PIECE("("), STR_PIECE(", "), STR_PIECE(")"), STR_PIECE(", "), STR_PIECE(")"),
+};
+
+static const RenderStyle frozenReprStyle = {
+    STR_PIECE("FrozenProcSet("), STR_PIECE("("), STR_PIECE(", "), STR_PIECE(")"), STR_PIECE(", "), STR_PIECE(")"),
+};
+
+static const char _digit_pairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+static inline Py_ALWAYS_INLINE int
+_nb_digits(pset_boundary_t value){
+    if (value < 10) return 1;
+    if (value < 100) return 2;
+    if (value < 1000) return 3;
+    if (value < 10000) return 4;
+    if (value < 100000) return 5;
+    if (value < 1000000) return 6;
+    if (value < 10000000) return 7;
+    if (value < 100000000) return 8;
+    if (value < 1000000000) return 9;
+    return 10;
+}
+
+// writes value in decimal on exactly digits characters, two digits per iteration
+static inline Py_ALWAYS_INLINE char *
+_write_uint(char * dst, pset_boundary_t value, int digits){
+    char * p = dst + digits;
+    while (value >= 100){
+        pset_boundary_t pair = (value % 100) * 2;
+        value /= 100;
+        *--p = _digit_pairs[pair + 1];
+        *--p = _digit_pairs[pair];
+    }
+    if (value >= 10){
+        *--p = _digit_pairs[value * 2 + 1];
+        *--p = _digit_pairs[value * 2];
+    } else {
+        *--p = (char) ('0' + value);
+    }
+    return dst + digits;
+}
+
+static inline char *
+_write_piece(char * dst, StrPiece piece){
+    memcpy(dst, piece.str, piece.len);
+    return dst + piece.len;
+}
+
+static bool
+_piece_is_ascii(StrPiece piece){
+    for (Py_ssize_t i = 0; i < piece.len; i++){
+        if ((unsigned char) piece.str[i] >= 0x80){
+            return false;
+        }
+    }
+    return true;
+}
+
+static PyObject *
+_render(ProcSetObject * self, const RenderStyle * style){
+    const pset_boundary_t * bounds = self->_boundaries;
+    Py_ssize_t nb = self->nb_boundary;
+
+    // both passes read the boundaries by pairs, an unpaired one would be read and written past the end
+    if (nb % 2){
+        PyErr_Format(PyExc_SystemError, "corrupted procset: odd number of boundaries (%zd)", nb);
+        return NULL;
+    }
+
+    // first pass: the exact size of the result
+    Py_ssize_t size = style->prefix.len + style->suffix.len;
+    if (nb){
+        size += (nb / 2 - 1) * style->outsep.len;
+    }
+    Py_ssize_t range_extra = style->open.len + style->insep.len + style->close.len;
+    for (Py_ssize_t i = 0; i < nb; i += 2){
+        size += _nb_digits(bounds[i]);
+        if (bounds[i+1] != bounds[i] + 1){
+            size += range_extra + _nb_digits(bounds[i+1] - 1);
+        }
+    }
 
-static PyObject *
-_format(ProcSetObject * self, PyObject * insep, PyObject* outsep){
-    // early termination if the pset is empty
-    if (!self->nb_boundary){
-        return PyUnicode_FromString("");
+    // with ASCII separators the result is written straight into the final str
+    bool ascii = _piece_is_ascii(style->prefix) && _piece_is_ascii(style->open) && _piece_is_ascii(style->insep)
+        && _piece_is_ascii(style->close) && _piece_is_ascii(style->outsep) && _piece_is_ascii(style->suffix);
+    PyObject * result = NULL;
+    char * buffer;
+    if (ascii){
+        result = PyUnicode_New(size, 127);
+        if (!result){
+            return NULL;
+        }
+        buffer = (char *) PyUnicode_1BYTE_DATA(result);
+    } else {
+        buffer = PyMem_Malloc(size ? size : 1);
+        if (!buffer){
+            return PyErr_NoMemory();
+        }
     }
-    
-    // une liste de string d'intervals
-    // +1 ref -> 1
-    PyObject * list = PyList_New(self->nb_boundary / 2);
-
-    for (Py_ssize_t i = 0, curr = 0; i < self->nb_boundary; i += 2, curr++){
-        pset_boundary_t a = self->_boundaries[i];
-        pset_boundary_t b = self->_boundaries[i+1];
-
-        PyObject * itv;
-        if (b == a+1){
-            // +1 ref -> 2
-            itv = PyUnicode_FromFormat("%li", a);       // a single value
+
+    // second pass: writing
+    char * p = _write_piece(buffer, style->prefix);
+    for (Py_ssize_t i = 0; i < nb; i += 2){
+        if (i){
+            p = _write_piece(p, style->outsep);
+        }
+        pset_boundary_t a = bounds[i];
+        pset_boundary_t b = bounds[i+1] - 1;       // [a,b[ -> a-(b-1)
+        if (a == b){
+            p = _write_uint(p, a, _nb_digits(a));       // a single value
         } else {
-            // +1 ref -> 2
-            itv = PyUnicode_FromFormat("%li%U%li", a, insep, b-1);      // [a,b[ -> a-(b-1)
+            p = _write_piece(p, style->open);
+            p = _write_uint(p, a, _nb_digits(a));
+            p = _write_piece(p, style->insep);
+            p = _write_uint(p, b, _nb_digits(b));
+            p = _write_piece(p, style->close);
         }
+    }
+    p = _write_piece(p, style->suffix);
+    assert(p - buffer == size);
 
-        // -1 ref -> 1
-        PyList_SetItem(list, curr, itv);        // does not steal a a ref
-    }  
-
-    PyObject * result = PyUnicode_Join(outsep, list);
-    // -1 ref -> 0
-    Py_DECREF(list);
+    if (!ascii){
+        result = PyUnicode_DecodeUTF8(buffer, size, NULL);
+        PyMem_Free(buffer);
+    }
     return result;
 }
 
-// __format__
-static PyObject*
-ProcSet_format(ProcSetObject * self, PyObject * args){
-    Py_ssize_t lenOfArgs = PyTuple_Size(args);
-    if (lenOfArgs == 0){
-        PyErr_SetString(PyExc_ValueError, "Invalid format specifier");
+static PyObject *
+_format(ProcSetObject * self, PyObject * insep, PyObject* outsep){
+    RenderStyle style = strStyle;
+    style.insep.str = PyUnicode_AsUTF8AndSize(insep, &style.insep.len);
+    style.outsep.str = PyUnicode_AsUTF8AndSize(outsep, &style.outsep.len);
+    if (!style.insep.str || !style.outsep.str){
         return NULL;
     }
+    return _render(self, &style);
+}
 
-    // PyTuple_GetItem returns a borrowed ref
-    PyObject * _str = PyTuple_GetItem(args, 0);
+// __format__
+static PyObject*
+ProcSet_format(ProcSetObject * self, PyObject * _str){
     Py_ssize_t len_str;
 
     // arg[0] should be a string of length 0 | 2
@@ -962,45 +2726,7 @@ ProcSet_format(ProcSetObject * self, PyObject * args){
 // __repr__
 static PyObject *
 ProcSet_repr(ProcSetObject *self){
-    // early termination if the pset is empty
-    if (!self->nb_boundary){
-        return PyUnicode_FromString("ProcSet()");
-    }
-    
-    // une liste de string d'intervals
-    // +1 ref -> 1
-    PyObject * list = PyList_New(self->nb_boundary / 2);
-
-    // +1 ref -> 2
-    PyObject * outsep = PyUnicode_FromString(", ");
-
-    for (Py_ssize_t i = 0, curr = 0; i < self->nb_boundary; i += 2, curr++){
-        pset_boundary_t a = self->_boundaries[i];
-        pset_boundary_t b = self->_boundaries[i+1];
-
-        PyObject * itv;
-        if (b == a+1){
-            // +1 ref -> 3
-            itv = PyUnicode_FromFormat("%li", a);       // a single value
-        } else {
-            // +1 ref -> 3
-            itv = PyUnicode_FromFormat("(%li, %li)", a, b-1);      // [a,b[ -> a-(b-1)
-        }
-
-        // -1 ref -> 2
-        PyList_SetItem(list, curr, itv);        // does not steal a a ref
-    }  
-
-    // +1 ref -> 3
-    PyObject * joined = PyUnicode_Join(outsep, list);
-    // -2 ref -> 1
-    Py_DECREF(list);
-    Py_DECREF(outsep);
-
-    PyObject * result = PyUnicode_FromFormat("ProcSet(%U)", joined);
-    // -1 ref -> 0
-    Py_DECREF(joined);
-    return result;
+    return _render(self, FrozenPSet_Check(self) ? &frozenReprStyle : &reprStyle);
 }
 
 // __str__
@@ -1008,13 +2734,7 @@ static PyObject *
 ProcSet_str(ProcSetObject *self)
 {
     // this function is just an alias for ProcSet().__format__("- ");
-    PyObject * insep = PyUnicode_FromString("-");
-    PyObject * outsep = PyUnicode_FromString(" ");
-    PyObject * res = _format(self, insep, outsep);
-
-    Py_DECREF(insep);
-    Py_DECREF(outsep);
-    return res;
+    return _render(self, &strStyle);
 }
 
 
@@ -1027,23 +2747,50 @@ ProcSequence_length(ProcSetObject* self){
         PyErr_SetString(PyExc_Exception, "self is null !");
         return -1;
     } 
-    // early return: length is zero if the list is null
-    else if(!self->_boundaries){
-        return 0;
+
+    // the number of processors is computed every time the boundaries are written
+    return self->length;
+}
+
+// returns the prefix sums of the interval lengths, computes them if needed
+// the array has nb_boundary/2 + 1 cells, the last one being the length of the set
+static Py_ssize_t *
+_get_prefix(ProcSetObject *self){
+    if (self->_prefix){
+        return self->_prefix;
     }
 
-    // somme de la taille de tout les intervals de la structure
-    Py_ssize_t res = 0;
+    Py_ssize_t nb_itv = self->nb_boundary / 2;
+    self->_prefix = (Py_ssize_t *) PyMem_Malloc((nb_itv + 1) * sizeof(Py_ssize_t));
+    if (!self->_prefix){
+        PyErr_NoMemory();
+        return NULL;
+    }
 
-    // pour chaque interval
-    for (int i = 0; i < self->nb_boundary; i+=2){
-        //On ajoute sa taille au résultat
-        //La taille n'a pas besoin de +1 car intervals semi ouverts
-        res += self->_boundaries[i+1] - self->_boundaries[i]; 
+    Py_ssize_t sum = 0;
+    for (Py_ssize_t itv = 0; itv < nb_itv; itv++){
+        self->_prefix[itv] = sum;
+        sum += self->_boundaries[2*itv+1] - self->_boundaries[2*itv];
     }
+    self->_prefix[nb_itv] = sum;
 
-    //On retourne le résultat
-    return res;
+    return self->_prefix;
+}
+
+// returns the index of the interval holding the processor at position pos (0 <= pos < len)
+// binary search of the last interval starting before pos: prefix[low] <= pos < prefix[high]
+static Py_ssize_t
+_find_interval(const Py_ssize_t * prefix, Py_ssize_t nb_itv, Py_ssize_t pos){
+    Py_ssize_t low = 0, high = nb_itv;
+    while (high - low > 1){
+        Py_ssize_t mid = low + (high - low) / 2;
+        if (prefix[mid] <= pos){
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
 }
 
 // __getitem__
@@ -1056,43 +2803,52 @@ static PyObject* ProcSequence_getItem(ProcSetObject *self, Py_ssize_t pos){
         return NULL;
     }
 
-    int i = 0;          //position                
-    int itv = 0;        //current interval
-    while (i < pos){
-        pset_boundary_t a = self->_boundaries[itv];                 // left element of the current interval
-        pset_boundary_t b = self->_boundaries[itv+1];               // right element of the current interval
-
-        if ((pos - i) < b-a) { // if the interval we're looking for is inside the current interval
-            break;
-        }
-
-        i += (b-a);
-        itv += 2;
+    Py_ssize_t * prefix = _get_prefix(self);
+    if (!prefix){
+        return NULL;
     }
 
+    Py_ssize_t itv = _find_interval(prefix, self->nb_boundary / 2, pos);
+
     // ith element
-    return PyLong_FromUnsignedLong(self->_boundaries[itv] + (pset_boundary_t) (pos - i));
+    return PyLong_FromUnsignedLong(self->_boundaries[2*itv] + (pset_boundary_t) (pos - prefix[itv]));
+}
+
+// returns the index of the first boundary strictly greater than value (nb_boundary if there is none)
+static Py_ssize_t
+_upper_bound(const pset_boundary_t * boundaries, Py_ssize_t size, pset_boundary_t value){
+    Py_ssize_t low = 0, high = size;
+    while (low < high){
+        Py_ssize_t mid = low + (high - low) / 2;
+        if (boundaries[mid] <= value){
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
 }
 
 // __contains__
 static int ProcSequence_contains(ProcSetObject* self, PyObject* val){
     // conversion of the PyObject to a C object
-    pset_boundary_t value = (pset_boundary_t) PyLong_AsUnsignedLong(val);
+    unsigned long value = PyLong_AsUnsignedLong(val);
+    if (value == (unsigned long) -1 && PyErr_Occurred()){
+        // negative or too big numbers can't be in the set
+        if (PyErr_ExceptionMatches(PyExc_OverflowError)){
+            PyErr_Clear();
+            return false;
+        }
+        return -1;
+    }
 
     // easiest case: the value is greater than the last proc or lower than the first proc
-    if (!self->_boundaries || value < *(self->_boundaries) || value >= self->_boundaries[self->nb_boundary - 1]){
+    if (!self->nb_boundary || value < *(self->_boundaries) || value >= self->_boundaries[self->nb_boundary - 1]){
         return false;
     }
 
-    // if not, we're going to need to go through the intervals
-    int itv = 0;
-    
-    //while we still have intervals to go through and the value is bigger than the upper bound of the current interval
-    while (itv < self->nb_boundary && self->_boundaries[itv+1] <= value){        // <= cause !>
-        itv += 2;
-    }
-
-    return self->_boundaries[itv] <= value;        // the value is in the set if it's bigger than the lower bound
+    // the value is inside an interval if the first boundary above it is an upper bound
+    return _upper_bound(self->_boundaries, self->nb_boundary, (pset_boundary_t) value) % 2 != 0;
 } 
 
 // Liste des methodes qui permettent a procset d'etre utilisé comme un objet sequence
@@ -1104,6 +2860,50 @@ PySequenceMethods ProcSequenceMethods = {
 
 
 
+// A slice walker, goes through count processors of the set, starting at position first and
+// moving step (> 0) positions forward each time. The walk is a single pass over the intervals.
+typedef struct {
+    const pset_boundary_t * boundaries;
+    Py_ssize_t itv;             // the current interval
+    pset_boundary_t value;      // the current processor
+} SliceWalker;
+
+// places the walker on the processor at position first
+static int
+_slice_walker_init(SliceWalker * walker, ProcSetObject * self, Py_ssize_t first){
+    Py_ssize_t * prefix = _get_prefix(self);
+    if (!prefix){
+        return 0;
+    }
+
+    walker->boundaries = self->_boundaries;
+    walker->itv = _find_interval(prefix, self->nb_boundary / 2, first);
+    walker->value = self->_boundaries[2 * walker->itv] + (pset_boundary_t) (first - prefix[walker->itv]);
+    return 1;
+}
+
+// moves the walker step processors forward, the caller makes sure it stays inside the set
+static inline void
+_slice_walker_next(SliceWalker * walker, Py_ssize_t step){
+    // processors left in the current interval, the current one included
+    Py_ssize_t remaining = walker->boundaries[2 * walker->itv + 1] - walker->value;
+
+    if (step < remaining){
+        walker->value += (pset_boundary_t) step;
+        return;
+    }
+
+    // we skip the end of the current interval, then every interval too small to hold the next processor
+    step -= remaining;
+    walker->itv++;
+    Py_ssize_t itv_len;
+    while (step >= (itv_len = walker->boundaries[2 * walker->itv + 1] - walker->boundaries[2 * walker->itv])){
+        step -= itv_len;
+        walker->itv++;
+    }
+    walker->value = walker->boundaries[2 * walker->itv] + (pset_boundary_t) step;
+}
+
 // getslice 
 static PyObject*
 ProcsetMapping_getSlice(ProcSetObject *self, Py_ssize_t start, Py_ssize_t stop, Py_ssize_t step){
@@ -1121,19 +2921,142 @@ ProcsetMapping_getSlice(ProcSetObject *self, Py_ssize_t start, Py_ssize_t stop,
     // si liste vide
     else if (!len) return res;
 
-    // i l'iterateur, pos la position dans la liste destination
-    Py_ssize_t i, pos;
+    // we always walk forward, a negative step fills the list from the end
+    Py_ssize_t first = step > 0 ? start : start + (len - 1) * step;
+    Py_ssize_t pos = step > 0 ? 0 : len - 1;
+    Py_ssize_t dir = step > 0 ? 1 : -1;
+    step = step > 0 ? step : -step;
+
+    SliceWalker walker;
+    if (!_slice_walker_init(&walker, self, first)){
+        Py_DECREF(res);
+        return NULL;
+    }
+
+    // fast path, every processor of the intervals we go through is taken
+    if (step == 1){
+        Py_ssize_t done = 0;
+        while (done < len){
+            pset_boundary_t upper = self->_boundaries[2 * walker.itv + 1];
+            for (pset_boundary_t value = walker.value; value < upper && done < len; value++, done++, pos += dir){
+                PyObject * obj = PyLong_FromUnsignedLong(value);
+                if (!obj){
+                    Py_DECREF(res);
+                    return NULL;
+                }
+                // macro car par besoin de clear les references d'une liste vide
+                PyList_SET_ITEM(res, pos, obj);
+            }
 
-    for (i = start, pos = 0; pos < len; i += step, pos++) {
-        PyObject * obj = PySequence_GetItem((PyObject*) self,i);
+            // next interval
+            walker.itv++;
+            if (done < len){
+                walker.value = self->_boundaries[2 * walker.itv];
+            }
+        }
+        return res;
+    }
 
-        // macro car par besoin de clear les references d'une liste vide
+    for (Py_ssize_t done = 0; done < len; done++, pos += dir) {
+        PyObject * obj = PyLong_FromUnsignedLong(walker.value);
+        if (!obj){
+            Py_DECREF(res);
+            return NULL;
+        }
         PyList_SET_ITEM(res, pos, obj);
+
+        if (done + 1 < len){
+            _slice_walker_next(&walker, step);
+        }
     }
 
     return res;
 }
 
+// getslice, the result is a procset instead of a list
+static PyObject*
+_getSlice_pset(ProcSetObject *self, Py_ssize_t start, Py_ssize_t stop, Py_ssize_t step){
+    if (step == 0){
+        PyErr_SetString(PyExc_ValueError, "slice step cannot be zero");
+        return NULL;
+    } 
+
+    ProcSetObject * result = _pset_new(Py_TYPE(self));
+    Py_ssize_t len = PySlice_AdjustIndices(ProcSequence_length(self), &start, &stop, step);
+    if (!result || !len){
+        return (PyObject *) result;
+    }
+
+    // a set has no order, a negative step selects the same processors as its positive counterpart
+    Py_ssize_t first = step > 0 ? start : start + (len - 1) * step;
+    step = step > 0 ? step : -step;
+
+    SliceWalker walker;
+    if (!_slice_walker_init(&walker, self, first)){
+        Py_DECREF(result);
+        return NULL;
+    }
+
+    // with step == 1 we keep the intervals from the first processor to the last one, otherwise
+    // no two processors are contiguous and every one of them is its own interval
+    Py_ssize_t last_itv = walker.itv;
+    if (step == 1){
+        Py_ssize_t * prefix = self->_prefix;
+        last_itv = _find_interval(prefix, self->nb_boundary / 2, first + len - 1);
+    }
+    Py_ssize_t nb_boundary = step == 1 ? 2 * (last_itv - walker.itv + 1) : 2 * len;
+
+    if (!pset_alloc_boundaries(result, nb_boundary)){
+        Py_DECREF(result);
+        return NULL;
+    }
+
+    if (step == 1){
+        memcpy(result->_boundaries, self->_boundaries + 2 * walker.itv, nb_boundary * sizeof(pset_boundary_t));
+        result->_boundaries[0] = walker.value;
+        result->_boundaries[nb_boundary - 1] = self->_boundaries[2 * last_itv] + (pset_boundary_t) (first + len - self->_prefix[last_itv]);
+    } else {
+        for (Py_ssize_t done = 0; done < len; done++){
+            result->_boundaries[2 * done] = walker.value;
+            result->_boundaries[2 * done + 1] = walker.value + 1;
+
+            if (done + 1 < len){
+                _slice_walker_next(&walker, step);
+            }
+        }
+    }
+
+    result->nb_boundary = nb_boundary;
+    result->length = len;
+    return (PyObject *) result;
+}
+
+// slice(stop) / slice(start, stop[, step]) / slice(slice_object)
+static PyObject*
+ProcSet_slice(ProcSetObject *self, PyObject * const * args, Py_ssize_t nargs){
+    PyObject * key;
+    
+    // a slice object can be given as is
+    if (nargs == 1 && PySlice_Check(args[0])){
+        key = Py_NewRef(args[0]);
+    } else {
+        // same signature as the builtin slice
+        key = PyObject_Vectorcall((PyObject *) &PySlice_Type, args, nargs, NULL);
+        if (!key){
+            return NULL;
+        }
+    }
+
+    Py_ssize_t start, stop, step;
+    int unpacked = PySlice_Unpack(key, &start, &stop, &step);
+    Py_DECREF(key);
+    if (unpacked < 0) {
+        return NULL;
+    }
+
+    return _getSlice_pset(self, start, stop, step);
+}
+
 // subscript, same signature as PyObject_getItem
 static PyObject*
 ProcsetMapping_subscript(PyObject * self, PyObject * _key){
@@ -1181,52 +3104,51 @@ PyMappingMethods ProcSetMappingMethods = {
 // __eq__ and __ne__
 static int
 ProcSet_eq(ProcSetObject* self, ProcSetObject* other){
-    // easiest case: they don't have the same number of element -> not equal
-    if (self->nb_boundary != other->nb_boundary){
-        return false;
+    if (self == other){
+        return true;
     }
 
-    // parcours de la liste sur self->nb_boundaries car self self->nb_boundary == other->nb_boundary
-    Py_ssize_t i = 0;
-    while (i < self->nb_boundary && self->_boundaries[i] == other->_boundaries[i]){
-        i++;
+    // unequal procsets are almost always told apart here, without reading their boundaries
+    if (pset_fingerprint_differs(self, other)){
+        return false;
     }
 
-    // the intervals are the same if we didn't stop
-    return i == self->nb_boundary;
+    // the boundaries of equal procsets are identical, memcmp compares them with the widest
+    // vector instructions the cpu supports (selected at runtime by the libc).
+    // It goes through a few dozen boundaries in the time the merge kernel processes one, hence the scaled size
+    ProcSetObject * operands[2] = {self, other};
+    PyThreadState * state = pset_begin_nogil(operands, 2, self->nb_boundary / 32);
+    int equal = !self->nb_boundary || !memcmp(self->_boundaries, other->_boundaries, self->nb_boundary * sizeof(pset_boundary_t));
+    pset_end_nogil(state, operands, 2);
+    return equal;
 }
 
+// returns true if every element of self is in other (self <= other)
 static int _sub_super(ProcSetObject * self, ProcSetObject * other){
-    PyObject * intersection = ProcSet_and(self, (PyObject * ) other);
-    if (!intersection){
-        return -1;
-    }
+    // self is a subset if no processor of self is missing from other
+    return !(relation_sweep(self, other, PSET_LEFT_ONLY) & PSET_LEFT_ONLY);
+}
 
-    // self is a subset if every element is already in other
-    int result = ProcSet_eq((ProcSetObject * ) intersection, self);
-    
-    ProcSet_dealloc((ProcSetObject *) intersection);    // we released the memory used by the intersection
-    return result;
+// returns true if self is a strict subset of other (self < other)
+static int _strict_sub_super(ProcSetObject * self, ProcSetObject * other){
+    // the sweep only stops early when self is not a subset, 
+    // otherwise it went through every region and PSET_RIGHT_ONLY is reliable
+    int found = relation_sweep(self, other, PSET_LEFT_ONLY);
+    return !(found & PSET_LEFT_ONLY) && (found & PSET_RIGHT_ONLY);
 }
 
-static PyObject *
-_NonOperatorParsing(PyObject * args){
-    Py_ssize_t lenOfArgs = PySequence_Check(args) ? PySequence_Size(args) : 0;
+// returns true if self and other have no processor in common
+static int _disjoint(ProcSetObject * self, ProcSetObject * other){
+    return !(relation_sweep(self, other, PSET_COMMON) & PSET_COMMON);
+}
 
-    // not enough argmuments
-    if (!lenOfArgs){
-        PyErr_SetString(PyExc_TypeError, "takes exactly one argument (0 given)");
-        return NULL;
-    } 
-    // too many arguments
-    else if (lenOfArgs > 1){
-        PyErr_SetString(PyExc_TypeError, "takes exactly one argument");
-        return NULL;
+static PyObject *
+_NonOperatorParsing(PyObject * arg0){
+    // a procset is used as is, it is only read
+    if (PSet_Check(arg0)){
+        return Py_NewRef(arg0);
     }
 
-    // we get the given argument
-    PyObject * arg0 = PySequence_GetItem(args, 0);
-
     // it needs to be iterable
     if (!_isIterable(arg0)){
         //TODO : v DECOMMENT WHEN FIXED IN PY_PROCSET
@@ -1236,60 +3158,59 @@ _NonOperatorParsing(PyObject * args){
         Py_RETURN_NOTIMPLEMENTED;
     }
 
-    return _pset_factory(arg0);
+    // the items of the iterable are the arguments of the constructor, like ProcSet(*arg0)
+    PyObject * items = PySequence_Fast(arg0, "given object is not iterable");
+    if (!items){
+        return NULL;
+    }
+    PyObject * res = (PyObject *) _get_pset_from_args(PySequence_Fast_ITEMS(items), PySequence_Fast_GET_SIZE(items));
+    Py_DECREF(items);
+    return res;
 }
 // issubset
 static PyObject *
-ProcSet_issubset(ProcSetObject *self, PyObject * args){
-    PyObject * other = _NonOperatorParsing(args);
+ProcSet_issubset(ProcSetObject *self, PyObject * arg){
+    PyObject * other = _NonOperatorParsing(arg);
     if (!other || other == Py_NotImplemented){
         //return _handle_err_notimpl();
         return other;
     }
 
     PyObject * result = PyBool_FromLong(_sub_super(self, (ProcSetObject *) other));
-    // ProcSet_dealloc((ProcSetObject *) other);
+    Py_DECREF(other);
     return result;
 }
 
-// issubset
+// issuperset
 static PyObject *
-ProcSet_issuperset(ProcSetObject *self, PyObject * args){
-    PyObject * other = _NonOperatorParsing(args);
+ProcSet_issuperset(ProcSetObject *self, PyObject * arg){
+    PyObject * other = _NonOperatorParsing(arg);
     if (!other || other == Py_NotImplemented){
         return other;
     }
     
     PyObject * result = PyBool_FromLong(_sub_super((ProcSetObject *) other, self));
-    ProcSet_dealloc((ProcSetObject *) other);
+    Py_DECREF(other);
     return result;
 }
 
 // isdisjoint
 static PyObject *
-ProcSet_isdisjoint(ProcSetObject *self, PyObject * args){
-    PyObject * other = _NonOperatorParsing(args);
+ProcSet_isdisjoint(ProcSetObject *self, PyObject * arg){
+    PyObject * other = _NonOperatorParsing(arg);
     if (!other || other == Py_NotImplemented){
         return other;
     }
 
-    ProcSetObject * intersection = (ProcSetObject* ) ProcSet_and(self, other);
-
-    if (!intersection){
-        return NULL;
-    }
-
-    int result = intersection->nb_boundary == 0;
-    ProcSet_dealloc(intersection);          // we release the resulting procset
-    ProcSet_dealloc((ProcSetObject *) other);
-
-    return PyBool_FromLong(result);
+    PyObject * result = PyBool_FromLong(_disjoint(self, (ProcSetObject *) other));
+    Py_DECREF(other);
+    return result;
 }
 
 // richcompare function
 static PyObject* ProcSet_richcompare(ProcSetObject* self, PyObject* _other, int operation){
-    //we compare the types:
-    if (!Py_IS_TYPE(_other, Py_TYPE((PyObject*)self))){
+    //we compare the types, a ProcSet and a FrozenProcSet can be compared:
+    if (!PSet_Check(_other)){
         Py_RETURN_NOTIMPLEMENTED;
     }
 
@@ -1299,7 +3220,7 @@ static PyObject* ProcSet_richcompare(ProcSetObject* self, PyObject* _other, int
     switch (operation){
         case Py_LT:{ // <
             // issubset and is different
-            return PyBool_FromLong(! ProcSet_eq(self, other) && _sub_super(self, other));
+            return PyBool_FromLong(_strict_sub_super(self, other));
         };
 
         case Py_LE:{ // <=
@@ -1317,11 +3238,11 @@ static PyObject* ProcSet_richcompare(ProcSetObject* self, PyObject* _other, int
 
         case Py_GT:{ // >
             // is superset and is different
-            return PyBool_FromLong(!ProcSet_eq(self, other) && _sub_super(other, self));
+            return PyBool_FromLong(_strict_sub_super(other, self));
         };
 
         case Py_GE:{ // >=
-            // is subset and is different
+            // is superset
             return PyBool_FromLong(_sub_super(other, self));
         };
     }
@@ -1332,19 +3253,19 @@ static PyObject* ProcSet_richcompare(ProcSetObject* self, PyObject* _other, int
 
 // methods
 static PyMethodDef ProcSet_methods[] = {
-    {"union", (PyCFunction) ProcSet_union, METH_VARARGS, "Function that perform the assemblist union operation and return a new ProcSet"},
-    {"update", (PyCFunction) ProcSet_update, METH_VARARGS, "Update the ProcSet, adding elements from all others."},
-    {"insert", (PyCFunction) ProcSet_update, METH_VARARGS, "Update the ProcSet, adding elements from all others, Alias for 'update()'"},
-    {"intersection", (PyCFunction) ProcSet_intersection, METH_VARARGS, "Function that perform the assemblist intersection operation and return a new ProcSet"},
-    {"intersection_update", (PyCFunction) ProcSet_update_intersection, METH_VARARGS, "Update the ProcSet, keeping only elements found in the ProcSet and all others."},
-    {"difference", (PyCFunction) ProcSet_difference, METH_VARARGS, "Function that perform the assemblist difference operation and return a new ProcSet"},
-    {"difference_update", (PyCFunction) ProcSet_update_difference, METH_VARARGS, "Update the ProcSet, removing elements found in others. "},
-    {"discard", (PyCFunction) ProcSet_update_difference, METH_VARARGS, "Update the ProcSet, removing elements found in others, Alias for 'difference_update()'"},
-    {"symmetric_difference", (PyCFunction) ProcSet_symmetricDifference, METH_VARARGS, "Function that perform the assemblist symmetric difference operation and return a new ProcSet"},
-    {"symmetric_difference_update", (PyCFunction) ProcSet_update_symmetricDifference, METH_VARARGS, "Update the ProcSet, keeping only elements found in either the ProcSet or *other*, but not in both."},
-    {"issubset", (PyCFunction) ProcSet_issubset, METH_VARARGS, "Test whether every element in the ProcSet is in *other*"},
-    {"issuperset", (PyCFunction) ProcSet_issuperset, METH_VARARGS, "Test whether every element in *other* is in the ProcSet."},
-    {"isdisjoint", (PyCFunction) ProcSet_isdisjoint, METH_VARARGS, "Return ``True`` if the ProcSet has no processor in common with *other*."},
+    {"union", (PyCFunction)(void(*)(void)) ProcSet_union, METH_FASTCALL, "Function that perform the assemblist union operation and return a new ProcSet"},
+    {"update", (PyCFunction)(void(*)(void)) ProcSet_update, METH_FASTCALL, "Update the ProcSet, adding elements from all others."},
+    {"insert", (PyCFunction)(void(*)(void)) ProcSet_update, METH_FASTCALL, "Update the ProcSet, adding elements from all others, Alias for 'update()'"},
+    {"intersection", (PyCFunction)(void(*)(void)) ProcSet_intersection, METH_FASTCALL, "Function that perform the assemblist intersection operation and return a new ProcSet"},
+    {"intersection_update", (PyCFunction)(void(*)(void)) ProcSet_update_intersection, METH_FASTCALL, "Update the ProcSet, keeping only elements found in the ProcSet and all others."},
+    {"difference", (PyCFunction)(void(*)(void)) ProcSet_difference, METH_FASTCALL, "Function that perform the assemblist difference operation and return a new ProcSet"},
+    {"difference_update", (PyCFunction)(void(*)(void)) ProcSet_update_difference, METH_FASTCALL, "Update the ProcSet, removing elements found in others. "},
+    {"discard", (PyCFunction)(void(*)(void)) ProcSet_update_difference, METH_FASTCALL, "Update the ProcSet, removing elements found in others, Alias for 'difference_update()'"},
+    {"symmetric_difference", (PyCFunction)(void(*)(void)) ProcSet_symmetricDifference, METH_FASTCALL, "Function that perform the assemblist symmetric difference operation and return a new ProcSet"},
+    {"symmetric_difference_update", (PyCFunction)(void(*)(void)) ProcSet_update_symmetricDifference, METH_FASTCALL, "Update the ProcSet, keeping only elements found in either the ProcSet or *other*, but not in both."},
+    {"issubset", (PyCFunction) ProcSet_issubset, METH_O, "Test whether every element in the ProcSet is in *other*"},
+    {"issuperset", (PyCFunction) ProcSet_issuperset, METH_O, "Test whether every element in *other* is in the ProcSet."},
+    {"isdisjoint", (PyCFunction) ProcSet_isdisjoint, METH_O, "Return ``True`` if the ProcSet has no processor in common with *other*."},
     {"aggregate", (PyCFunction) ProcSet_aggregate, METH_NOARGS, 
     "Return a new ProcSet that is the convex hull of the given ProcSet.\n"
     "\n"
@@ -1354,12 +3275,30 @@ static PyMethodDef ProcSet_methods[] = {
     "of the smallest unique interval containing all intervals from the\n"
     "non-empty ProcSet."},
     {"from_str", (PyCFunction)(void(*)(void)) ProcSet_fromStr, METH_CLASS | METH_VARARGS | METH_KEYWORDS, ""},
-    {"__format__", (PyCFunction) ProcSet_format, METH_VARARGS, ""},
+    {"from_iterable", (PyCFunction) ProcSet_fromIterable, METH_CLASS | METH_O, ""},
+    {"from_indices", (PyCFunction) ProcSet_fromIterable, METH_CLASS | METH_O, ""},
+    {"from_boundaries", (PyCFunction) ProcSet_fromBoundaries, METH_CLASS | METH_O, ""},
+    {"__format__", (PyCFunction) ProcSet_format, METH_O, ""},
     {"clear", (PyCFunction) ProcSet_clear, METH_NOARGS, "Empties the ProcSet, removing all elements from it."},
+    {"reserve", (PyCFunction) ProcSet_reserve, METH_O, "Make room for *n* intervals, so that the ProcSet can grow up to this size without reallocating memory."},
+    {"shrink_to_fit", (PyCFunction) ProcSet_shrinkToFit, METH_NOARGS, "Release the memory reserved by the ProcSet but not used by its intervals."},
     {"copy", (PyCFunction) ProcSet_copy, METH_NOARGS, "Returns a new ProcSet with a shallow copy of the ProcSet."},
     {"__copy__", (PyCFunction) ProcSet_copy, METH_NOARGS, "Returns a new ProcSet with a shallow copy of the ProcSet."},
-    {"__deepcopy__", (PyCFunction) ProcSet_deepcopy, METH_VARARGS, "Returns a new copy of the ProcSet."},
+    {"__deepcopy__", (PyCFunction) ProcSet_deepcopy, METH_O, "Returns a new copy of the ProcSet."},
+    {"to_bytes", (PyCFunction) ProcSet_toBytes, METH_NOARGS, "Returns a compact binary encoding of the ProcSet, see ``from_bytes()``."},
+    {"from_bytes", (PyCFunction) ProcSet_fromBytes, METH_CLASS | METH_O, "Builds a ProcSet from the output of ``to_bytes()``."},
+    {"__reduce__", (PyCFunction) ProcSet_reduce, METH_NOARGS, ""},
+    {"__setstate__", (PyCFunction) ProcSet_setstate, METH_O, ""},
     {"intervals", (PyCFunction) ProcSet_intervals, METH_NOARGS, "Returns an iterator over the intervals of the ProcSet in increasing order."},
+    {"__reversed__", (PyCFunction) ProcSet_reversed, METH_NOARGS, "Returns an iterator over the processors of the ProcSet in decreasing order."},
+    {"intervals_list", (PyCFunction)(void(*)(void)) ProcSet_intervalsList, METH_FASTCALL, 
+    "Returns the intervals of the ProcSet as a list of ``(a, b)`` tuples in increasing order.\n"
+    "*start* and *stop* restrict it to a chunk of the intervals, with the semantics of a slice."},
+    {"slice", (PyCFunction)(void(*)(void)) ProcSet_slice, METH_FASTCALL, 
+    "Return a new ProcSet with the processors selected by slice(start, stop[, step]).\n"
+    "\n"
+    "Contrary to ``pset[start:stop:step]``, which returns a list of processors,\n"
+    "the intervals of the ProcSet are preserved."},
     {"count", (PyCFunction) ProcSet_count, METH_NOARGS, "Returns the number of disjoint intervals in the ProcSet."},
     {"iscontiguous", (PyCFunction) ProcSet_iscontiguous, METH_NOARGS, "Returns ``True`` if the ProcSet is made of a unique interval."},
     {NULL, NULL, 0, NULL}
@@ -1370,7 +3309,6 @@ static PyTypeObject ProcSetType = {
     PyVarObject_HEAD_INIT(NULL, 0)
     .tp_name = "procset.ProcSet",                           // __name__
     .tp_doc = "\n\tSet of non-overlapping (i.e., disjoint) non-negative integer intervals.\n",   // __doc__
-    .tp_version_tag = 1,                                    // version
     .tp_basicsize = sizeof(ProcSetObject),                  // size of the struct
     .tp_itemsize = 0,                                       // additional size values for dynamic objects
     .tp_repr = (reprfunc) ProcSet_repr,                     // __repr__
@@ -1378,23 +3316,266 @@ static PyTypeObject ProcSetType = {
     .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,   // flags, basetype is optional   
     .tp_new = (newfunc) ProcSet_new,                        // __new__
     .tp_init = (initproc) ProcSet_init,                     // __init__
+    .tp_vectorcall = (vectorcallfunc) ProcSet_vectorcall,   // ProcSet(...), without __new__ and __init__
     .tp_dealloc = (destructor) ProcSet_dealloc,             // Method called when the object is not referenced anymore, frees the memory and calls tp_free 
     .tp_methods = ProcSet_methods,                          // the list of defined methods for this object
     .tp_getset = ProcSet_getset,                            // the list of defined getters and setters
     .tp_as_sequence = &ProcSequenceMethods,                 // pointer to the sequence object
     .tp_richcompare = (richcmpfunc) ProcSet_richcompare,    // __le__, __eq__...
     .tp_as_number = &ProcSet_number_methods,                // __and__, __or__ ...
-    .tp_iter = (getiterfunc) PySeqIter_New,                 // __iter__
-    .tp_iternext = (iternextfunc) PyIter_Next,              // __next__
+    .tp_iter = (getiterfunc) ProcSet_iter,                  // __iter__
+    .tp_as_mapping = &ProcSetMappingMethods,
+    .tp_as_buffer = &ProcSetBufferMethods,                  // read-only view on the boundaries
+};
+
+
+// FrozenProcSet: an immutable and hashable ProcSet, usable as a dict key or in a set
+// It shares the storage, the merge engine and most of the methods of ProcSet.
+// Its boundaries are parsed by __new__ and never change afterwards.
+static PyObject *
+FrozenProcSet_new(PyTypeObject *type, PyObject *args, PyObject *Py_UNUSED(kwds)){
+    // like frozenset, FrozenProcSet(frozen) is frozen itself
+    if (type == &FrozenProcSetType && PyTuple_GET_SIZE(args) == 1 && Py_IS_TYPE(PyTuple_GET_ITEM(args, 0), &FrozenProcSetType)){
+        return Py_NewRef(PyTuple_GET_ITEM(args, 0));
+    }
+
+    ProcSetObject * parsed = _get_pset_from_args(PySequence_Fast_ITEMS(args), PyTuple_GET_SIZE(args));
+    if (!parsed){
+        return NULL;
+    }
+
+    ProcSetObject * self = _pset_new(type);
+    if (self){
+        pset_steal_boundaries(self, parsed);
+    }
+    Py_DECREF(parsed);
+    return (PyObject *) self;
+}
+
+// __hash__, computed once
+static Py_hash_t
+FrozenProcSet_hash(ProcSetObject *self){
+    if (!self->hash){
+        self->hash = pset_hash_boundaries(self->_boundaries, self->nb_boundary);
+    }
+    return self->hash;
+}
+
+// copy: an immutable object is its own copy
+static PyObject *
+FrozenProcSet_copy(ProcSetObject *self, PyObject *Py_UNUSED(args)){
+    if (Py_IS_TYPE(self, &FrozenProcSetType)){
+        return Py_NewRef(self);
+    }
+    return _pset_copy(self, &FrozenProcSetType);
+}
+
+static PyObject *
+FrozenProcSet_deepcopy(ProcSetObject *self, PyObject *Py_UNUSED(memo)){
+    return FrozenProcSet_copy(self, NULL);
+}
+
+// the operators of ProcSet, without the inplace ones: a |= b rebinds a to a new FrozenProcSet
+static PyNumberMethods FrozenProcSet_number_methods = {
+    .nb_subtract            = (binaryfunc) ProcSet_sub,
+    .nb_bool                = (inquiry) ProcSet_bool,
+    .nb_and                 = (binaryfunc) ProcSet_and,
+    .nb_xor                 = (binaryfunc) ProcSet_xor,
+    .nb_or                  = (binaryfunc) ProcSet_or,
+};
+
+// the methods of ProcSet that don't modify it
+static PyMethodDef FrozenProcSet_methods[] = {
+    {"union", (PyCFunction)(void(*)(void)) ProcSet_union, METH_FASTCALL, "Return a new FrozenProcSet with the processors of the FrozenProcSet and all others."},
+    {"intersection", (PyCFunction)(void(*)(void)) ProcSet_intersection, METH_FASTCALL, "Return a new FrozenProcSet with the processors common to the FrozenProcSet and all others."},
+    {"difference", (PyCFunction)(void(*)(void)) ProcSet_difference, METH_FASTCALL, "Return a new FrozenProcSet with the processors of the FrozenProcSet that are not in the others."},
+    {"symmetric_difference", (PyCFunction)(void(*)(void)) ProcSet_symmetricDifference, METH_FASTCALL, "Return a new FrozenProcSet with the processors in either the FrozenProcSet or *other*, but not in both."},
+    {"issubset", (PyCFunction) ProcSet_issubset, METH_O, "Test whether every element in the FrozenProcSet is in *other*"},
+    {"issuperset", (PyCFunction) ProcSet_issuperset, METH_O, "Test whether every element in *other* is in the FrozenProcSet."},
+    {"isdisjoint", (PyCFunction) ProcSet_isdisjoint, METH_O, "Return ``True`` if the FrozenProcSet has no processor in common with *other*."},
+    {"aggregate", (PyCFunction) ProcSet_aggregate, METH_NOARGS, "Return a new FrozenProcSet that is the convex hull of the given FrozenProcSet."},
+    {"from_str", (PyCFunction)(void(*)(void)) ProcSet_fromStr, METH_CLASS | METH_VARARGS | METH_KEYWORDS, ""},
+    {"from_iterable", (PyCFunction) ProcSet_fromIterable, METH_CLASS | METH_O, ""},
+    {"from_indices", (PyCFunction) ProcSet_fromIterable, METH_CLASS | METH_O, ""},
+    {"from_boundaries", (PyCFunction) ProcSet_fromBoundaries, METH_CLASS | METH_O, ""},
+    {"__format__", (PyCFunction) ProcSet_format, METH_O, ""},
+    {"copy", (PyCFunction) FrozenProcSet_copy, METH_NOARGS, "Returns the FrozenProcSet itself, it is immutable."},
+    {"__copy__", (PyCFunction) FrozenProcSet_copy, METH_NOARGS, "Returns the FrozenProcSet itself, it is immutable."},
+    {"__deepcopy__", (PyCFunction) FrozenProcSet_deepcopy, METH_O, "Returns the FrozenProcSet itself, it is immutable."},
+    {"to_bytes", (PyCFunction) ProcSet_toBytes, METH_NOARGS, "Returns a compact binary encoding of the FrozenProcSet, see ``from_bytes()``."},
+    {"from_bytes", (PyCFunction) ProcSet_fromBytes, METH_CLASS | METH_O, "Builds a FrozenProcSet from the output of ``to_bytes()``."},
+    {"__reduce__", (PyCFunction) ProcSet_reduce, METH_NOARGS, ""},
+    {"intervals", (PyCFunction) ProcSet_intervals, METH_NOARGS, "Returns an iterator over the intervals of the FrozenProcSet in increasing order."},
+    {"__reversed__", (PyCFunction) ProcSet_reversed, METH_NOARGS, "Returns an iterator over the processors of the FrozenProcSet in decreasing order."},
+    {"intervals_list", (PyCFunction)(void(*)(void)) ProcSet_intervalsList, METH_FASTCALL, "Returns the intervals of the FrozenProcSet as a list of ``(a, b)`` tuples in increasing order."},
+    {"slice", (PyCFunction)(void(*)(void)) ProcSet_slice, METH_FASTCALL, "Return a new FrozenProcSet with the processors selected by slice(start, stop[, step])."},
+    {"count", (PyCFunction) ProcSet_count, METH_NOARGS, "Returns the number of disjoint intervals in the FrozenProcSet."},
+    {"iscontiguous", (PyCFunction) ProcSet_iscontiguous, METH_NOARGS, "Returns ``True`` if the FrozenProcSet is made of a unique interval."},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyTypeObject FrozenProcSetType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "procset.FrozenProcSet",                     // __name__
+    .tp_doc = "\n\tImmutable and hashable set of non-overlapping (i.e., disjoint) non-negative integer intervals.\n",   // __doc__
+    .tp_basicsize = sizeof(ProcSetObject),                  // same struct as ProcSet
+    .tp_itemsize = 0,
+    .tp_repr = (reprfunc) ProcSet_repr,                     // __repr__
+    .tp_str = (reprfunc) ProcSet_str,                       // __str__
+    .tp_hash = (hashfunc) FrozenProcSet_hash,               // __hash__
+    .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+    .tp_new = (newfunc) FrozenProcSet_new,                  // __new__, there is no __init__
+    .tp_vectorcall = (vectorcallfunc) ProcSet_vectorcall,   // FrozenProcSet(...), without __new__
+    .tp_dealloc = (destructor) ProcSet_dealloc,
+    .tp_methods = FrozenProcSet_methods,
+    .tp_getset = ProcSet_getset,
+    .tp_as_sequence = &ProcSequenceMethods,
+    .tp_richcompare = (richcmpfunc) ProcSet_richcompare,    // compares with ProcSet too
+    .tp_as_number = &FrozenProcSet_number_methods,
+    .tp_iter = (getiterfunc) ProcSet_iter,
     .tp_as_mapping = &ProcSetMappingMethods,
+    .tp_as_buffer = &ProcSetBufferMethods,
+};
+
+// set_gallop_ratio
+static PyObject *
+procset_set_gallop_ratio(PyObject *Py_UNUSED(module), PyObject *arg){
+    Py_ssize_t ratio = PyLong_AsSsize_t(arg);
+    if (ratio == -1 && PyErr_Occurred()){
+        return NULL;
+    }
+    if (ratio < 0 || ratio > PSET_MAX_GALLOP_RATIO){
+        PyErr_Format(PyExc_ValueError, "the gallop ratio must be between 0 and %zd", (Py_ssize_t) PSET_MAX_GALLOP_RATIO);
+        return NULL;
+    }
+
+    Py_ssize_t previous = gallop_ratio;
+    gallop_ratio = ratio;
+    return PyLong_FromSsize_t(previous);
+}
+
+// set_merge_threads
+static PyObject *
+procset_set_merge_threads(PyObject *Py_UNUSED(module), PyObject *arg){
+    Py_ssize_t threads = PyLong_AsSsize_t(arg);
+    if (threads == -1 && PyErr_Occurred()){
+        return NULL;
+    }
+    if (threads < 1 || threads > PSET_POOL_MAX_THREADS){
+        PyErr_Format(PyExc_ValueError, "the number of merge threads must be between 1 and %d", PSET_POOL_MAX_THREADS);
+        return NULL;
+    }
+
+    Py_ssize_t previous = merge_threads;
+    merge_threads = threads;
+    return PyLong_FromSsize_t(previous);
+}
+
+// _run_merge_kernel, for benchmarks/bench_merge_kernel.py
+// Runs the merge kernel of an operation repeat times on the boundaries of two procsets, without
+// allocating nor counting the processors of the result, and returns the number of boundaries of the result.
+static PyObject *
+procset_run_merge_kernel(PyObject *Py_UNUSED(module), PyObject *args){
+    const char * name;
+    ProcSetObject * lpset, * rpset;
+    Py_ssize_t repeat;
+    if (!PyArg_ParseTuple(args, "sOOn:_run_merge_kernel", &name, &lpset, &rpset, &repeat)){
+        return NULL;
+    }
+    if (!PSet_Check(lpset) || !PSet_Check(rpset)){
+        PyErr_SetString(PyExc_TypeError, "_run_merge_kernel() expects two procsets");
+        return NULL;
+    }
+
+    static const struct {
+        const char * name;
+        MergeKernel kernel;
+    } kernels[] = {
+        {"union", mergeUnion},
+        {"intersection", mergeIntersection},
+        {"difference", mergeDifference},
+        {"symmetric_difference", mergeSymmetricDifference},
+    };
+    MergeKernel kernel = NULL;
+    for (size_t i = 0; i < sizeof(kernels) / sizeof(kernels[0]); i++){
+        if (!strcmp(name, kernels[i].name)){
+            kernel = kernels[i].kernel;
+        }
+    }
+    if (!kernel){
+        PyErr_Format(PyExc_ValueError, "unknown operation: '%s'", name);
+        return NULL;
+    }
+
+    Py_ssize_t maxBound = lpset->nb_boundary + rpset->nb_boundary;
+    pset_boundary_t * out = (pset_boundary_t *) PyMem_Malloc((maxBound ? maxBound : 1) * sizeof(pset_boundary_t));
+    if (!out){
+        return PyErr_NoMemory();
+    }
+
+    Py_ssize_t nb_boundary = 0;
+    for (Py_ssize_t i = 0; i < repeat; i++){
+        nb_boundary = kernel(lpset->_boundaries, lpset->nb_boundary, rpset->_boundaries, rpset->nb_boundary, out, gallop_ratio);
+    }
+
+    PyMem_Free(out);
+    return PyLong_FromSsize_t(nb_boundary);
+}
+
+// _alloc_stats, for benchmarks/bench_freelist.py
+// Returns the counters of the free list of procsets, see pset_freelist.
+static PyObject *
+procset_alloc_stats(PyObject *Py_UNUSED(module), PyObject *Py_UNUSED(args)){
+    Py_ssize_t free = 0;
+    for (int bucket = 0; bucket < PSET_FREELIST_BUCKETS; bucket++){
+        free += pset_freelist.sizes[bucket];
+    }
+
+    return Py_BuildValue("{sKsKsKsKsn}",
+                         "allocations", pset_freelist.allocations,
+                         "reused_objects", pset_freelist.reused_objects,
+                         "reused_buffers", pset_freelist.reused_buffers,
+                         "released", pset_freelist.released,
+                         "free", free);
+}
+
+// module level functions
+static PyMethodDef procset_module_methods[] = {
+    {"set_gallop_ratio", (PyCFunction) procset_set_gallop_ratio, METH_O, 
+    "Set the size ratio between two operands from which merges gallop through the bigger one.\n"
+    "\n"
+    "A ratio of 0 disables galloping, it can't exceed 2**31 - 1 (on 64 bits). Returns the previous ratio."},
+    {"set_merge_threads", (PyCFunction) procset_set_merge_threads, METH_O, 
+    "Set the number of threads merging two big procsets, each one merges a part of them.\n"
+    "\n"
+    "1 (the default) disables parallel merges. Only merges of hundreds of thousands of boundaries are split,\n"
+    "smaller ones are faster on a single thread. Returns the previous number of threads."},
+    {"_run_merge_kernel", (PyCFunction) procset_run_merge_kernel, METH_VARARGS, 
+    "_run_merge_kernel(operation, lhs, rhs, repeat)\n"
+    "\n"
+    "Runs the merge kernel of operation repeat times, for benchmarks. Returns the number of boundaries of the result."},
+    {"_alloc_stats", (PyCFunction) procset_alloc_stats, METH_NOARGS, 
+    "_alloc_stats()\n"
+    "\n"
+    "Returns the counters of the free list of procsets: the number of allocations, how many of them reused\n"
+    "a dead procset and its buffer, the number of procsets released into the free list, and its current size."},
+    {NULL, NULL, 0, NULL}
 };
 
+// releases the procsets kept by the free list when the module is freed
+static void
+procset_free(void *Py_UNUSED(module)){
+    _freelist_clear();
+}
+
 // basic Module definition
 static PyModuleDef procsetmodule = {
     PyModuleDef_HEAD_INIT,
     .m_name = "procset",
     .m_doc = "\nToolkit to manage sets of closed intervals.\n\nThis implementation requires intervals bounds to be non-negative integers. This\ndesign choice has been made as procset aims at managing resources for\nscheduling. Hence, the manipulated intervals can be represented as indexes.\n",
     .m_size = -1,
+    .m_methods = procset_module_methods,
+    .m_free = procset_free,
 };
 
 // basic module init function
@@ -1402,9 +3583,11 @@ PyMODINIT_FUNC PyInit_procset(void)
 {
     PyObject *m;
     if (PyType_Ready(&ProcSetType) < 0) return NULL;
+    if (PyType_Ready(&FrozenProcSetType) < 0) return NULL;
 
     IntervalIterType.tp_new = PyType_GenericNew;
     if (PyType_Ready(&IntervalIterType) < 0) return NULL;
+    if (PyType_Ready(&ElementIterType) < 0) return NULL;
 
     m = PyModule_Create(&procsetmodule);
     if (m == NULL) return NULL;
@@ -1416,5 +3599,12 @@ PyMODINIT_FUNC PyInit_procset(void)
         return NULL;
     }
 
+    Py_INCREF(&FrozenProcSetType);
+    if (PyModule_AddObject(m, "FrozenProcSet", (PyObject *) &FrozenProcSetType) < 0) {
+        Py_DECREF(&FrozenProcSetType);
+        Py_DECREF(m);
+        return NULL;
+    }
+
     return m;
 }
@@ -0,0 +1,124 @@
+#ifndef PROCSET_THREADPOOL_H_
+#define PROCSET_THREADPOOL_H_
+
+#include <Python.h>
+#include <pthread.h>
+#include <stdbool.h>
+
+// A small pool of worker threads running the partitions of parallel merges, see _binary_merge.
+// The workers are started on demand and never call the Python API, they can run without the GIL.
+// The pool runs one job at a time, a job is a number of tasks run by the workers and by the calling thread.
+
+// the maximum number of threads taking part in a job, the calling thread included
+#define PSET_POOL_MAX_THREADS 64
+
+// a task of a job, index is its number in [0, number of tasks[
+typedef void (*PoolTask)(void * arg, Py_ssize_t index);
+
+static struct {
+    pthread_mutex_t lock;
+    pthread_cond_t wake;            // the workers wait for a job on it
+    pthread_cond_t done;            // the calling thread waits for the end of its job on it
+
+    pthread_t workers[PSET_POOL_MAX_THREADS - 1];
+    int nb_workers;
+    bool atfork;                    // whether pset_pool_atfork_child is registered
+
+    // the current job
+    bool busy;
+    PoolTask task;
+    void * arg;
+    Py_ssize_t nb_tasks;
+    Py_ssize_t next_task;           // the next task to start
+    Py_ssize_t pending;             // the number of tasks not over yet
+} pset_pool = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .wake = PTHREAD_COND_INITIALIZER,
+    .done = PTHREAD_COND_INITIALIZER,
+};
+
+// runs the tasks of the current job until there is none left to start, the lock must be held
+static void
+_pset_pool_work(void){
+    while (pset_pool.next_task < pset_pool.nb_tasks){
+        Py_ssize_t index = pset_pool.next_task++;
+        PoolTask task = pset_pool.task;
+        void * arg = pset_pool.arg;
+
+        pthread_mutex_unlock(&pset_pool.lock);
+        task(arg, index);
+        pthread_mutex_lock(&pset_pool.lock);
+
+        if (--pset_pool.pending == 0){
+            pthread_cond_signal(&pset_pool.done);
+        }
+    }
+}
+
+static void *
+_pset_pool_worker(void * Py_UNUSED(arg)){
+    pthread_mutex_lock(&pset_pool.lock);
+    for (;;){
+        while (pset_pool.next_task >= pset_pool.nb_tasks){
+            pthread_cond_wait(&pset_pool.wake, &pset_pool.lock);
+        }
+        _pset_pool_work();
+    }
+    return NULL;
+}
+
+// the workers don't exist anymore in a forked child, neither does a job another thread was running
+static void
+pset_pool_atfork_child(void){
+    pthread_mutex_init(&pset_pool.lock, NULL);
+    pthread_cond_init(&pset_pool.wake, NULL);
+    pthread_cond_init(&pset_pool.done, NULL);
+    pset_pool.nb_workers = 0;
+    pset_pool.busy = false;
+    pset_pool.nb_tasks = pset_pool.next_task = pset_pool.pending = 0;
+}
+
+// Runs task(arg, i) for every i in [0, nb_tasks[ on up to nb_threads threads, the calling one included,
+// and returns once they are all over. Can be called without the GIL.
+// Returns 0 without running anything if the pool is already running the job of another thread.
+// Workers that can't be started are not an error: the tasks are run by the threads available.
+static int
+pset_pool_run(Py_ssize_t nb_tasks, PoolTask task, void * arg, int nb_threads){
+    pthread_mutex_lock(&pset_pool.lock);
+    if (pset_pool.busy){
+        pthread_mutex_unlock(&pset_pool.lock);
+        return 0;
+    }
+
+    if (!pset_pool.atfork){
+        pset_pool.atfork = pthread_atfork(NULL, NULL, pset_pool_atfork_child) == 0;
+    }
+    if (nb_threads > PSET_POOL_MAX_THREADS){
+        nb_threads = PSET_POOL_MAX_THREADS;
+    }
+    while (pset_pool.nb_workers < nb_threads - 1
+           && !pthread_create(&pset_pool.workers[pset_pool.nb_workers], NULL, _pset_pool_worker, NULL)){
+        pthread_detach(pset_pool.workers[pset_pool.nb_workers]);
+        pset_pool.nb_workers++;
+    }
+
+    pset_pool.busy = true;
+    pset_pool.task = task;
+    pset_pool.arg = arg;
+    pset_pool.nb_tasks = pset_pool.pending = nb_tasks;
+    pset_pool.next_task = 0;
+    pthread_cond_broadcast(&pset_pool.wake);
+
+    // the calling thread takes its share of the tasks, and waits for the ones the workers started
+    _pset_pool_work();
+    while (pset_pool.pending){
+        pthread_cond_wait(&pset_pool.done, &pset_pool.lock);
+    }
+
+    pset_pool.busy = false;
+    pset_pool.nb_tasks = pset_pool.next_task = 0;
+    pthread_mutex_unlock(&pset_pool.lock);
+    return 1;
+}
+
+#endif
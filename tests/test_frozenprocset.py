@@ -0,0 +1,96 @@
+# -*- coding: utf-8 -*-
+
+import copy
+import pickle
+
+import pytest
+from procset import FrozenProcSet, ProcSet
+
+
+# pylint: disable=no-self-use,missing-docstring
+class TestFrozenProcSet:
+    def test_new(self):
+        fpset = FrozenProcSet((0, 3), 7)
+        assert fpset == ProcSet((0, 3), 7)
+        assert len(fpset) == 5
+        assert list(fpset) == [0, 1, 2, 3, 7]
+
+    def test_new_from_frozen_is_identity(self):
+        fpset = FrozenProcSet(1)
+        assert FrozenProcSet(fpset) is fpset
+        assert fpset.copy() is fpset
+        assert copy.deepcopy(fpset) is fpset
+
+    def test_display(self):
+        fpset = FrozenProcSet((0, 3), 7)
+        assert repr(fpset) == 'FrozenProcSet((0, 3), 7)'
+        assert str(fpset) == '0-3 7'
+
+    def test_immutable(self):
+        fpset = FrozenProcSet(1)
+        for method in ('update', 'clear', 'discard', 'intersection_update', 'reserve'):
+            assert not hasattr(fpset, method)
+
+    def test_hash(self):
+        assert hash(FrozenProcSet((0, 3), 7)) == hash(FrozenProcSet(7, 0, 1, (2, 3)))
+        assert hash(FrozenProcSet()) == hash(FrozenProcSet())
+        with pytest.raises(TypeError):
+            hash(ProcSet(1))
+
+    def test_dict_key(self):
+        cache = {FrozenProcSet((0, 3)): 'a', FrozenProcSet(1): 'b'}
+        assert cache[FrozenProcSet(ProcSet((0, 3)))] == 'a'
+        assert len({FrozenProcSet(i % 5) for i in range(100)}) == 5
+
+    def test_compare_with_procset(self):
+        fpset, pset = FrozenProcSet((0, 3)), ProcSet((0, 3))
+        assert fpset == pset and pset == fpset
+        assert FrozenProcSet(1) < pset
+        assert pset >= FrozenProcSet(1)
+        assert pset.issuperset(FrozenProcSet(1, 2))
+        assert FrozenProcSet(1).isdisjoint(ProcSet(2))
+
+    @pytest.mark.parametrize('operator', (
+        lambda lhs, rhs: lhs | rhs,
+        lambda lhs, rhs: lhs & rhs,
+        lambda lhs, rhs: lhs - rhs,
+        lambda lhs, rhs: lhs ^ rhs,
+    ))
+    def test_operators_keep_left_type(self, operator):
+        fpset, pset = FrozenProcSet((0, 3)), ProcSet((2, 5))
+        assert type(operator(fpset, pset)) is FrozenProcSet
+        assert type(operator(pset, fpset)) is ProcSet
+        assert operator(fpset, pset) == operator(ProcSet(fpset), pset)
+
+    def test_inplace_rebinds(self):
+        fpset = original = FrozenProcSet(1)
+        fpset |= ProcSet(2)
+        assert fpset == ProcSet(1, 2)
+        assert original == ProcSet(1)
+        assert type(fpset) is FrozenProcSet
+
+    def test_procset_inplace_with_frozen(self):
+        pset = ProcSet(1)
+        pset |= FrozenProcSet(2)
+        assert type(pset) is ProcSet
+        assert pset == ProcSet(1, 2)
+
+    def test_methods_return_frozen(self):
+        fpset = FrozenProcSet((0, 3))
+        assert type(fpset.union(7)) is FrozenProcSet
+        assert type(fpset.union()) is FrozenProcSet
+        assert type(fpset.aggregate()) is FrozenProcSet
+        assert type(fpset.slice(0, 2)) is FrozenProcSet
+        assert type(FrozenProcSet.from_str('0-3')) is FrozenProcSet
+        assert type(FrozenProcSet.from_iterable([1])) is FrozenProcSet
+
+    def test_procset_from_frozen(self):
+        assert ProcSet(FrozenProcSet((0, 3)), 7) == ProcSet((0, 3), 7)
+
+    @pytest.mark.parametrize('protocol', range(pickle.HIGHEST_PROTOCOL + 1))
+    def test_pickle(self, protocol):
+        fpset = FrozenProcSet((0, 3), 7)
+        clone = pickle.loads(pickle.dumps(fpset, protocol=protocol))
+        assert type(clone) is FrozenProcSet
+        assert clone == fpset
+        assert hash(clone) == hash(fpset)
@@ -21,6 +21,7 @@
 
 import copy
 import itertools
+import operator
 import pytest
 from procset import ProcSet
 
@@ -28,8 +29,11 @@ from procset import ProcSet
 # used by {TestNew,TestInsert}::test_incompatible_iter_length
 INCOMPATIBLE_ITER_LENGTH_TESTCASES = (
     (),  # length < 2
+    [],
     '',
     (0, ),
+    [3],
+    {3},
     '1',
     (0, 1, 2, ),  # length > 2
     '1-2',
@@ -129,6 +133,16 @@ class TestNew:
         with pytest.raises(TypeError, match=pattern):
             ProcSet(iterable)
 
+    @pytest.mark.parametrize('items', ((3, ), (0, 1, 2)), ids=repr)
+    def test_iter_length_mismatch(self, items):
+        class Liar(list):
+            def __len__(self):
+                return 2
+
+        pattern = '^Incompatible iterable, expected an iterable of exactly 2 int$'
+        with pytest.raises(TypeError, match=pattern):
+            ProcSet(Liar(items))
+
     @pytest.mark.parametrize('iterable', INCOMPATIBLE_ITER_TYPE_TESTCASES, ids=repr)
     def test_incompatible_iter_type(self, iterable):
                                 #pattern = r'^ProcInt\(\) argument (inf|sup) must be int$'
@@ -140,6 +154,38 @@ class TestNew:
         with pytest.raises(TypeError):
             ProcSet(None)
 
+    def test_single_arg_is_copied(self):
+        other = ProcSet((0, 3))
+        pset = ProcSet(other)
+        assert pset == other and pset is not other
+        pset |= ProcSet(9)
+        assert other == ProcSet((0, 3))
+
+    @pytest.mark.parametrize('arg, expected', (
+        (2**32 - 2, [2**32 - 2]),
+        ((4, 4), [4]),
+        ((2**32 - 3, 2**32 - 2), [2**32 - 3, 2**32 - 2]),
+    ))
+    def test_single_arg_limits(self, arg, expected):
+        assert list(ProcSet(arg)) == expected
+
+    def test_subclass_init(self):
+        class SubProcSet(ProcSet):
+            def __init__(self, *args):
+                super().__init__(*args)
+                self.initialized = True
+
+        pset = SubProcSet((0, 3))
+        assert isinstance(pset, SubProcSet)
+        assert pset.initialized
+        assert list(pset) == [0, 1, 2, 3]
+
+    def test_many_intervals(self):
+        pset = ProcSet(*((i, i + 1) for i in range(40, 0, -4)), 50, (2, 9), [60, 61], ProcSet(70))
+        expected = {i for i in range(4, 44, 4)} | {i + 1 for i in range(4, 44, 4)} | set(range(2, 10))
+        assert set(pset) == expected | {50, 60, 61, 70}
+        assert len(pset) == len(expected) + 4
+
 
 # pylint: disable=no-self-use,too-many-public-methods,missing-docstring
 class TestMisc:
@@ -272,6 +318,67 @@ class TestMisc:
     def test_intervals_mixed_points_intervals(self):
         assert list(ProcSet((6, 7), 12, (0, 3)).intervals()) == [(0, 3), (6, 7), (12, 12)]
 
+    def test_intervals_large_bounds(self):
+        assert list(ProcSet((2**32 - 4, 2**32 - 2)).intervals()) == [(2**32 - 4, 2**32 - 2)]
+
+    def test_intervals_length_hint(self):
+        itvs = ProcSet((6, 7), 12, (0, 3)).intervals()
+        assert operator.length_hint(itvs) == 3
+        next(itvs)
+        assert operator.length_hint(itvs) == 2
+
+    def test_intervals_kept_tuples(self):
+        # the iterator must not refill a tuple that is still referenced
+        itvs = ProcSet(0, 2, 4).intervals()
+        first = next(itvs)
+        assert list(itvs) == [(2, 2), (4, 4)]
+        assert first == (0, 0)
+
+    def test_intervals_mutated_procset(self):
+        pset = ProcSet(0, 2, 4)
+        itvs = pset.intervals()
+        next(itvs)
+        pset.clear()
+        assert list(itvs) == []
+
+    def test_intervals_list(self):
+        pset = ProcSet((6, 7), 12, (0, 3))
+        assert pset.intervals_list() == [(0, 3), (6, 7), (12, 12)]
+        assert ProcSet().intervals_list() == []
+
+    @pytest.mark.parametrize('bounds, expected', (
+        ((1,), [(6, 7), (12, 12)]),
+        ((0, 2), [(0, 3), (6, 7)]),
+        ((-1,), [(12, 12)]),
+        ((2, 1), []),
+        ((5, 10), []),
+    ))
+    def test_intervals_list_chunk(self, bounds, expected):
+        assert ProcSet((6, 7), 12, (0, 3)).intervals_list(*bounds) == expected
+
+    @pytest.mark.parametrize('pset, expected', (
+        (ProcSet(), []),
+        (ProcSet(3), [3]),
+        (ProcSet((6, 7), 12, (0, 3)), [0, 1, 2, 3, 6, 7, 12]),
+    ))
+    def test_iter(self, pset, expected):
+        assert list(pset) == expected
+        assert list(reversed(pset)) == expected[::-1]
+        assert operator.length_hint(iter(pset)) == len(expected)
+
+    def test_iter_mutated_procset(self):
+        pset = ProcSet((0, 5), (10, 12))
+        forward, backward = iter(pset), reversed(pset)
+        assert next(forward) == 0
+        assert next(backward) == 12
+        pset -= ProcSet((1, 2), (9, 11))
+        assert list(forward) == [3, 4, 5, 12]
+        assert list(backward) == [5, 4, 3, 0]
+
+    def test_not_an_iterator(self):
+        with pytest.raises(TypeError):
+            next(ProcSet(1))
+
     def test_iscontiguous_empty(self):
         assert ProcSet().iscontiguous()
 
@@ -328,11 +435,58 @@ class TestStringParsing:
         pset = ProcSet.from_str('0-1 2-3')
         assert pset == ProcSet((0, 3))
 
+    def test_unsorted_overlapping(self):
+        pset = ProcSet.from_str('8-9 0-3 2-5 7')
+        assert pset == ProcSet((0, 5), (7, 9))
+
+    def test_custom_separators(self):
+        pset = ProcSet.from_str('0..1, 4, 2..3', insep='..', outsep=', ')
+        assert pset == ProcSet((0, 4))
+
+    def test_generic_syntax(self):
+        pset = ProcSet.from_str('1_0-1_2')
+        assert pset == ProcSet((10, 12))
+
+    def test_generic_syntax_many(self):
+        pset = ProcSet.from_str('1_2 8-9 0-3 +5 2-4')
+        assert pset == ProcSet((0, 5), (8, 9), 12)
+        assert len(pset) == 9
+
+    def test_generic_syntax_invalid(self):
+        with pytest.raises(ValueError, match=r'^Invalid interval format, parsed string is: \'x\'$'):
+            ProcSet.from_str('1_0 x 4')
+
+    @pytest.mark.parametrize('string', ('1_0 5-2', '5-2 +7', '1_0 4-1_2 9-3'))
+    def test_generic_syntax_reversed(self, string):
+        with pytest.raises(ValueError, match=r'^Invalid interval format, parsed string is: \'\d-\d\'$'):
+            ProcSet.from_str(string)
+
+    # outsep inside insep: the sign of the first number sends the string to the generic parser,
+    # both parsers must agree
+    @pytest.mark.parametrize('string, insep, outsep', (
+        ('1 3', ' ', ' '),
+        ('1--2', '--', '-'),
+        ('0 - 2 4', ' - ', ' '),
+        ('1,,2,5', ',,', ','),
+    ))
+    def test_outsep_in_insep(self, string, insep, outsep):
+        def parse(string):
+            try:
+                return ProcSet.from_str(string, insep=insep, outsep=outsep)
+            except ValueError as error:
+                return str(error)
+
+        assert parse(string) == parse('+' + string)
+
+    def test_same_separators(self):
+        pset = ProcSet.from_str('1 3', insep=' ', outsep=' ')
+        assert pset == ProcSet(1, 3)
+
     def test_nostring(self):
         with pytest.raises(TypeError, match=r'^from_str\(\) argument 2 must be str, not int$'):
             ProcSet.from_str(42)
 
-    @pytest.mark.parametrize('string', ('-1', '0-', '1-2-3', ))
+    @pytest.mark.parametrize('string', ('-1', '0-', '1-2-3', '5-2', ))
     def test_invalid_string(self, string):
         pattern = r'^Invalid interval format, parsed string is: \'{}\'$'.format(string)
         with pytest.raises(ValueError, match=pattern):
@@ -386,6 +540,19 @@ class TestDisplay:
         assert repr(pset) == 'ProcSet((0, 3), (7, 15))'
         assert pset == eval(repr(pset))
 
+    def test_single_element_list(self):
+        # an unpaired boundary would be rendered past the end of the buffer
+        with pytest.raises(TypeError):
+            str(ProcSet([3]))
+        with pytest.raises(TypeError):
+            repr(ProcSet([3]))
+        with pytest.raises(TypeError):
+            format(ProcSet([3]), ':,')
+        pset = ProcSet([3, 3])
+        assert str(pset) == '3'
+        assert format(pset, ':,') == '3'
+        assert repr(pset) == 'ProcSet(3)'
+
     def test_bad_format_spec_short(self):
         with pytest.raises(ValueError, match='^Invalid format specifier$'):
             format(ProcSet(), ';')
@@ -0,0 +1,75 @@
+# -*- coding: utf-8 -*-
+
+import array
+
+import pytest
+from procset import ProcSet
+
+
+# pylint: disable=no-self-use,missing-docstring
+class TestBufferProtocol:
+    def test_view(self):
+        view = memoryview(ProcSet((0, 3), 7))
+        assert view.readonly
+        assert view.format == 'I'
+        assert view.itemsize == 4
+        assert view.tolist() == [0, 4, 7, 8]
+
+    def test_empty_view(self):
+        assert memoryview(ProcSet()).tolist() == []
+
+    def test_read_only(self):
+        with pytest.raises(TypeError):
+            memoryview(ProcSet(1))[0] = 1
+
+    @pytest.mark.parametrize('mutation', (
+        lambda pset: pset.clear(),
+        lambda pset: pset.update(5),
+        lambda pset: pset.difference_update(1),
+        lambda pset: pset.reserve(10),
+        lambda pset: pset.shrink_to_fit(),
+        lambda pset: pset.__init__(2),
+        lambda pset: pset.__ior__(ProcSet(9)),
+    ))
+    def test_locked_while_exported(self, mutation):
+        pset = ProcSet((0, 3))
+        with memoryview(pset):
+            with pytest.raises(BufferError):
+                mutation(pset)
+            assert pset == ProcSet((0, 3))
+        mutation(pset)
+
+    def test_iterable_of_procset(self):
+        assert ProcSet.from_iterable(ProcSet((2, 4))) == ProcSet((2, 4))
+
+
+# pylint: disable=no-self-use,missing-docstring
+class TestFromBoundaries:
+    def test_round_trip(self):
+        pset = ProcSet((0, 3), (7, 9), 20)
+        assert ProcSet.from_boundaries(memoryview(pset)) == pset
+        assert ProcSet.from_boundaries(pset) == pset
+
+    @pytest.mark.parametrize('typecode', ('B', 'H', 'i', 'I', 'q', 'Q'))
+    def test_integer_buffers(self, typecode):
+        pset = ProcSet.from_boundaries(array.array(typecode, [1, 5, 9, 10]))
+        assert pset == ProcSet((1, 4), 9)
+        assert len(pset) == 5
+
+    def test_empty(self):
+        assert ProcSet.from_boundaries(array.array('I')) == ProcSet()
+
+    @pytest.mark.parametrize('boundaries', ([1, 1], [3, 1], [1, 3, 3, 5], [1, 5, 2, 8], [1]))
+    def test_invalid(self, boundaries):
+        with pytest.raises(ValueError, match=r'^Invalid boundaries'):
+            ProcSet.from_boundaries(array.array('I', boundaries))
+
+    @pytest.mark.parametrize('boundaries', (array.array('i', [-1, 3]), array.array('q', [0, 2**32])))
+    def test_out_of_range(self, boundaries):
+        with pytest.raises(ValueError, match=r'^Invalid boundary'):
+            ProcSet.from_boundaries(boundaries)
+
+    @pytest.mark.parametrize('obj', ([1, 2], array.array('d', [1.0, 2.0])))
+    def test_not_a_buffer_of_integers(self, obj):
+        with pytest.raises(TypeError):
+            ProcSet.from_boundaries(obj)
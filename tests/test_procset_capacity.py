@@ -0,0 +1,120 @@
+# -*- coding: utf-8 -*-
+
+import pytest
+import procset
+from procset import ProcSet, FrozenProcSet
+
+
+# pylint: disable=no-self-use,missing-docstring
+class TestCapacity:
+    def test_reserve(self):
+        pset = ProcSet(0)
+        pset.reserve(10)
+        assert pset.capacity >= 10
+        assert pset == ProcSet(0)
+
+    def test_reserve_smaller_keeps_capacity(self):
+        pset = ProcSet()
+        pset.reserve(10)
+        pset.reserve(2)
+        assert pset.capacity >= 10
+
+    def test_reserve_invalid(self):
+        with pytest.raises(ValueError):
+            ProcSet().reserve(-1)
+        with pytest.raises(TypeError):
+            ProcSet().reserve('1')
+
+    @pytest.mark.parametrize('nb_itv', (2**61, 2**62, 2**63 - 1, 2**64))
+    def test_reserve_overflow(self, nb_itv):
+        pset = ProcSet(0)
+        with pytest.raises(OverflowError):
+            pset.reserve(nb_itv)
+        pset |= ProcSet((2, 40))
+        assert pset == ProcSet(0, (2, 40))
+
+    def test_shrink_to_fit(self):
+        pset = ProcSet(0, 2, 4)
+        pset.reserve(100)
+        pset.shrink_to_fit()
+        assert pset.capacity == pset.count() == 3
+        assert pset == ProcSet(0, 2, 4)
+
+    def test_clear_keeps_capacity(self):
+        pset = ProcSet(0, 2, 4)
+        capacity = pset.capacity
+        pset.clear()
+        assert pset == ProcSet()
+        assert pset.capacity == capacity
+        pset.shrink_to_fit()
+        assert pset.capacity == 0
+
+    def test_inplace_reuses_capacity(self):
+        pset = ProcSet()
+        pset.reserve(64)
+        for i in range(0, 64, 2):
+            pset |= ProcSet(i)
+        assert pset.capacity == 64
+        assert list(pset) == list(range(0, 64, 2))
+        pset &= ProcSet((0, 31))
+        assert pset.capacity == 64
+        assert pset.count() == 16
+
+    def test_small_procsets_are_inline(self):
+        assert ProcSet(0).capacity == 2
+        assert (ProcSet(0) | ProcSet(2)).capacity == 2
+        assert ProcSet((0, 1000), 2000).aggregate().capacity == 2
+
+    def test_spill_out_of_inline_storage(self):
+        pset = ProcSet(0)
+        pset |= ProcSet(2, 4, 6)
+        assert list(pset) == [0, 2, 4, 6]
+        pset -= ProcSet((2, 6))
+        pset.shrink_to_fit()
+        assert list(pset) == [0]
+        assert pset.capacity == 2
+
+
+class TestFreeList:
+    def test_dead_procset_is_reused(self):
+        dead = ProcSet(0, 2, 4)
+        del dead
+        before = procset._alloc_stats()
+        pset = ProcSet()
+        after = procset._alloc_stats()
+        assert after['reused_objects'] == before['reused_objects'] + 1
+        assert after['free'] == before['free'] - 1
+        assert pset == ProcSet() and pset.capacity == 0
+        assert len(pset) == 0
+
+    def test_buffer_is_reused(self):
+        pset = ProcSet(*range(0, 40, 2))
+        dead = pset.copy()
+        del dead
+        before = procset._alloc_stats()
+        copy = pset.copy()
+        after = procset._alloc_stats()
+        assert after['reused_buffers'] == before['reused_buffers'] + 1
+        assert copy == pset
+        assert len(copy) == len(pset)
+
+    def test_reused_with_another_type(self):
+        dead = FrozenProcSet(*range(0, 40, 2))
+        assert hash(dead) == hash(FrozenProcSet(*range(0, 40, 2)))
+        del dead
+        pset = ProcSet(*range(0, 20, 2)) | ProcSet(*range(20, 40, 2))
+        assert type(pset) is ProcSet
+        pset |= ProcSet(100)
+        assert 100 in pset
+        frozen = FrozenProcSet(1, 3)
+        assert type(frozen) is FrozenProcSet
+        assert hash(frozen) == hash(FrozenProcSet(1, 3))
+
+    def test_subclasses_are_not_kept(self):
+        class SubProcSet(ProcSet):
+            pass
+
+        dead = SubProcSet(0)
+        before = procset._alloc_stats()
+        del dead
+        assert procset._alloc_stats()['released'] == before['released']
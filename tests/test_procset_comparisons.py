@@ -27,7 +27,7 @@
 
 import collections
 import pytest
-from procset import ProcSet
+from procset import FrozenProcSet, ProcSet
 
 
 _TestCase = collections.namedtuple(
@@ -516,3 +516,27 @@ class Test__GE__(_TestComparisonOperator):
 
 class Test__GT__(_TestComparisonOperator):
     method = '__gt__'
+
+
+# pylint: disable=no-self-use,missing-docstring
+class TestEquality:
+    @pytest.mark.parametrize('lhs, rhs, expected', (
+        (ProcSet(), ProcSet(), True),
+        (ProcSet((0, 3), 7), ProcSet(7, (0, 3)), True),
+        (ProcSet((0, 3), 7), FrozenProcSet((0, 3), 7), True),
+        (ProcSet((0, 3)), ProcSet((0, 4)), False),
+        # same number of intervals, processors, first and last processors: only the middle differs
+        (ProcSet((0, 1), (5, 6), 9), ProcSet((0, 1), (6, 7), 9), False),
+        (FrozenProcSet((0, 1), (5, 6), 9), FrozenProcSet((0, 1), (6, 7), 9), False),
+    ))
+    def test_eq(self, lhs, rhs, expected):
+        assert (lhs == rhs) is expected
+        assert (rhs == lhs) is expected
+        assert (lhs != rhs) is not expected
+
+    def test_eq_after_mutation(self):
+        lhs, rhs = ProcSet((0, 1), 9), ProcSet((0, 1), 9)
+        lhs |= ProcSet(5)
+        assert lhs != rhs
+        rhs.update(5)
+        assert lhs == rhs
@@ -0,0 +1,61 @@
+# -*- coding: utf-8 -*-
+
+import array
+
+import pytest
+from procset import ProcSet
+
+
+# pylint: disable=no-self-use,too-many-public-methods,missing-docstring
+class TestFromIterable:
+    @pytest.mark.parametrize('method', ('from_iterable', 'from_indices'))
+    def test_unsorted_duplicates(self, method):
+        pset = getattr(ProcSet, method)([7, 3, 1, 2, 3, 9, 8])
+        assert pset == ProcSet((1, 3), (7, 9))
+        assert len(pset) == 6
+
+    def test_large_shuffled(self):
+        values = [(i * 7919) % 5003 for i in range(5003)] + [2**31 + 5, 2**32 - 3, 2**31 + 4]
+        assert ProcSet.from_iterable(values) == ProcSet((0, 5002), (2**31 + 4, 2**31 + 5), 2**32 - 3)
+
+    def test_empty(self):
+        assert ProcSet.from_iterable([]) == ProcSet()
+
+    def test_generator(self):
+        assert ProcSet.from_iterable(i * 2 for i in range(3)) == ProcSet(0, 2, 4)
+
+    @pytest.mark.parametrize('rng', (range(0, 10), range(9, -1, -1), range(0, 10, 3), range(5, 5)))
+    def test_range(self, rng):
+        assert ProcSet.from_iterable(rng) == ProcSet(*rng)
+
+    def test_huge_range(self):
+        pset = ProcSet.from_iterable(range(10**9))
+        assert pset == ProcSet((0, 10**9 - 1))
+
+    @pytest.mark.parametrize('typecode', ('b', 'B', 'h', 'H', 'i', 'I', 'l', 'L', 'q', 'Q'))
+    def test_buffer(self, typecode):
+        pset = ProcSet.from_iterable(array.array(typecode, [4, 0, 1, 2, 9]))
+        assert pset == ProcSet((0, 2), 4, 9)
+
+    def test_bytes(self):
+        assert ProcSet.from_iterable(b'\x00\x01\x05') == ProcSet((0, 1), 5)
+
+    @pytest.mark.parametrize('values', ([-1], [2**32], array.array('i', [-1])))
+    def test_out_of_range(self, values):
+        with pytest.raises(ValueError, match=r'^Invalid processor index'):
+            ProcSet.from_iterable(values)
+
+    @pytest.mark.parametrize('values', (['a'], [1.5], array.array('d', [1.0]), 42))
+    def test_not_integers(self, values):
+        with pytest.raises(TypeError):
+            ProcSet.from_iterable(values)
+
+    def test_subclass(self):
+        class SubProcSet(ProcSet):
+            pass
+        assert type(SubProcSet.from_iterable([1, 2])) is SubProcSet
+
+    def test_constructor_many_ints(self):
+        node_ids = list(range(0, 1000, 2)) + [5, 1, 3]
+        pset = ProcSet(*node_ids, (2000, 2002))
+        assert pset == ProcSet.from_iterable(node_ids + [2000, 2001, 2002])
@@ -0,0 +1,68 @@
+# -*- coding: utf-8 -*-
+
+import copy
+import pickle
+
+import pytest
+from procset import ProcSet
+
+
+PSETS = (
+    ProcSet(),
+    ProcSet(0),
+    ProcSet((0, 1023), (2048, 4095)),
+    ProcSet(1, (127, 128), (16383, 16384), 2**32 - 2),
+)
+
+
+# pylint: disable=no-self-use,missing-docstring
+class TestBytes:
+    @pytest.mark.parametrize('pset', PSETS)
+    def test_round_trip(self, pset):
+        data = pset.to_bytes()
+        assert isinstance(data, bytes)
+        assert ProcSet.from_bytes(data) == pset
+        assert ProcSet.from_bytes(bytearray(data)) == pset
+
+    def test_compact(self):
+        # 1 byte for the count, 2 per boundary
+        assert len(ProcSet((0, 1023), (2048, 4095)).to_bytes()) == 8
+
+    @pytest.mark.parametrize('data', (b'', b'\x01\x00', b'\x02\x05', b'\x02\x05\x00\x00', b'\x02\xff\xff\xff\xff\x1f\x00', b'\xff' * 12))
+    def test_invalid(self, data):
+        with pytest.raises(ValueError, match=r'^Invalid ProcSet encoding$'):
+            ProcSet.from_bytes(data)
+
+    def test_not_bytes(self):
+        with pytest.raises(TypeError):
+            ProcSet.from_bytes('0-3')
+
+
+# pylint: disable=no-self-use,missing-docstring
+class TestPickle:
+    @pytest.mark.parametrize('protocol', range(pickle.HIGHEST_PROTOCOL + 1))
+    @pytest.mark.parametrize('pset', PSETS)
+    def test_round_trip(self, pset, protocol):
+        clone = pickle.loads(pickle.dumps(pset, protocol=protocol))
+        assert type(clone) is ProcSet
+        assert clone == pset
+        assert len(clone) == len(pset)
+
+    def test_subclass(self):
+        clone = pickle.loads(pickle.dumps(SubProcSet(1, (3, 5))))
+        assert type(clone) is SubProcSet
+        assert clone == SubProcSet(1, (3, 5))
+
+    def test_setstate_locked_while_exported(self):
+        pset = ProcSet(1)
+        with memoryview(pset):
+            with pytest.raises(BufferError):
+                pset.__setstate__(ProcSet(2).to_bytes())
+
+    def test_copy(self):
+        pset = ProcSet((0, 3))
+        assert copy.deepcopy([pset]) == [pset]
+
+
+class SubProcSet(ProcSet):
+    pass
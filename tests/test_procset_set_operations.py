@@ -31,6 +31,7 @@
 import collections
 import itertools
 import pytest
+import procset
 from procset import ProcSet
 
 
@@ -2292,3 +2293,92 @@ class Test__OR__(_TestSetOperationsOperator):
     testcases = UNION_TESTCASES
     merge_method = '__or__'
     inplace_method = '__ior__'
+
+
+# operations with more than one operand are applied from left to right
+
+MANY_OPERANDS = (
+    ProcSet((0, 9)),
+    ProcSet((2, 6), 8),
+    ProcSet((5, 12)),
+    ProcSet(),
+)
+
+
+# pylint: disable=no-self-use,missing-docstring
+class TestManyOperands:
+    @pytest.mark.parametrize('merge_method, operator', (
+        ('union', '__or__'),
+        ('intersection', '__and__'),
+        ('difference', '__sub__'),
+        ('symmetric_difference', '__xor__'),
+    ))
+    def test_chained(self, merge_method, operator):
+        for size in range(1, len(MANY_OPERANDS) + 1):
+            for operands in itertools.permutations(MANY_OPERANDS, size):
+                expected = operands[0]
+                for other in operands[1:]:
+                    expected = getattr(expected, operator)(other)
+                assert getattr(operands[0], merge_method)(*operands[1:]) == expected
+
+    def test_intersection_is_not_union_of_others(self):
+        pset = ProcSet((0, 9))
+        assert pset.intersection(ProcSet((0, 4)), ProcSet((3, 9))) == ProcSet((3, 4))
+        assert pset.symmetric_difference(ProcSet(1), ProcSet(1)) == pset
+
+    def test_no_operand_is_a_copy(self):
+        pset = ProcSet((0, 9))
+        for method in ('union', 'intersection', 'difference', 'symmetric_difference'):
+            res = getattr(pset, method)()
+            assert res == pset
+            assert res is not pset
+
+    @pytest.mark.parametrize('merge_method, inplace_method, expected', (
+        ('union', 'update', ProcSet((0, 9))),
+        ('intersection', 'intersection_update', ProcSet((0, 9))),
+        ('difference', 'difference_update', ProcSet()),
+        ('symmetric_difference', 'symmetric_difference_update', ProcSet()),
+    ))
+    def test_self_operand(self, merge_method, inplace_method, expected):
+        pset = ProcSet((0, 9))
+        assert getattr(pset, merge_method)(pset) == expected
+        assert getattr(pset, inplace_method)(pset) is pset
+        assert pset == expected
+
+
+# the largest processor, its exclusive upper bound is the largest boundary
+MAX_PROC = 2**32 - 2
+
+
+class TestLargestProcessor:
+    @pytest.mark.parametrize('operator, expected', (
+        ('__or__', ProcSet((0, 4), (MAX_PROC - 2, MAX_PROC))),
+        ('__and__', ProcSet(MAX_PROC - 1)),
+        ('__sub__', ProcSet((0, 4), MAX_PROC)),
+        ('__xor__', ProcSet((0, 4), MAX_PROC - 2, MAX_PROC)),
+    ))
+    def test_operator(self, operator, expected):
+        left = ProcSet((0, 4), (MAX_PROC - 1, MAX_PROC))
+        right = ProcSet((MAX_PROC - 2, MAX_PROC - 1))
+        assert getattr(left, operator)(right) == expected
+        inplace = left.copy()
+        getattr(inplace, operator.replace('__', '__i', 1))(right)
+        assert inplace == expected
+
+
+class TestGallopRatio:
+    @pytest.mark.parametrize('ratio', (-1, 2**31, 2**62))
+    def test_out_of_range(self, ratio):
+        with pytest.raises(ValueError, match='^the gallop ratio must be between 0 and'):
+            procset.set_gallop_ratio(ratio)
+
+    @pytest.mark.parametrize('ratio', (0, 1, 2**31 - 1))
+    def test_operations(self, ratio):
+        previous = procset.set_gallop_ratio(ratio)
+        try:
+            big, small = ProcSet(*range(0, 200, 2)), ProcSet(7, (40, 43))
+            assert big | small == ProcSet.from_iterable(set(big) | set(small))
+            assert big & small == ProcSet(40, 42)
+            assert small - big == ProcSet(7, 41, 43)
+        finally:
+            assert procset.set_gallop_ratio(previous) == ratio
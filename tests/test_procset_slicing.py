@@ -0,0 +1,49 @@
+# -*- coding: utf-8 -*-
+
+import itertools
+import pytest
+from procset import ProcSet
+
+
+SLICING_PSETS = (
+    ProcSet(),
+    ProcSet(0),
+    ProcSet((0, 7)),
+    ProcSet(0, (2, 5), (9, 10), 14, (20, 27)),
+)
+SLICING_INDICES = (None, -30, -9, -1, 0, 1, 3, 8, 30)
+SLICING_STEPS = (None, 1, 2, 3, 7, -1, -2, -5)
+
+
+# pylint: disable=no-self-use,too-many-public-methods,missing-docstring
+class TestGetSlice:
+    @pytest.mark.parametrize('pset', SLICING_PSETS, ids=repr)
+    def test_list(self, pset):
+        expected = list(pset)
+        for start, stop, step in itertools.product(SLICING_INDICES, SLICING_INDICES, SLICING_STEPS):
+            assert pset[start:stop:step] == expected[start:stop:step]
+
+    @pytest.mark.parametrize('pset', SLICING_PSETS, ids=repr)
+    def test_procset(self, pset):
+        expected = list(pset)
+        for start, stop, step in itertools.product(SLICING_INDICES, SLICING_INDICES, SLICING_STEPS):
+            res = pset.slice(start, stop, step)
+            assert isinstance(res, ProcSet)
+            assert list(res) == sorted(expected[start:stop:step])
+            assert len(res) == len(expected[start:stop:step])
+
+    def test_procset_keeps_intervals(self):
+        pset = ProcSet((0, 3), (10, 13), (20, 23))
+        assert pset.slice(2, 10) == ProcSet((2, 3), (10, 13), (20, 21))
+        assert pset.slice(2, 10).count() == 3
+
+    def test_procset_signatures(self):
+        pset = ProcSet((0, 9))
+        assert pset.slice(3) == ProcSet((0, 2))
+        assert pset.slice(slice(2, None, 4)) == ProcSet(2, 6)
+
+    def test_zero_step(self):
+        with pytest.raises(ValueError):
+            ProcSet((0, 9)).slice(0, 5, 0)
+        with pytest.raises(ValueError):
+            ProcSet((0, 9))[::0]
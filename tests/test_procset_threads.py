@@ -0,0 +1,191 @@
+# -*- coding: utf-8 -*-
+
+# Merges and comparisons of big procsets run without the GIL, their operands are pinned meanwhile
+
+import functools
+import operator
+import random
+import threading
+import pytest
+import procset
+from procset import FrozenProcSet, ProcSet
+
+# enough intervals for every sweep to release the GIL
+NB_ITV = 20_000
+
+
+def _random_elements(seed):
+    rng = random.Random(seed)
+    elements = set()
+    for start in rng.sample(range(0, 8 * NB_ITV, 4), NB_ITV):
+        elements.update(range(start, start + rng.randint(1, 3)))
+    return elements
+
+
+LEFT = _random_elements(1)
+RIGHT = _random_elements(2)
+THIRD = _random_elements(3)
+
+OPERATORS = (
+    (operator.or_, operator.ior, 'union'),
+    (operator.and_, operator.iand, 'intersection'),
+    (operator.sub, operator.isub, 'difference'),
+    (operator.xor, operator.ixor, 'symmetric_difference'),
+)
+
+
+# pylint: disable=no-self-use,missing-docstring
+class TestWithoutGIL:
+    @pytest.mark.parametrize('op, iop, method', OPERATORS)
+    def test_operations(self, op, iop, method):
+        left, right = ProcSet.from_iterable(LEFT), ProcSet.from_iterable(RIGHT)
+        expected = ProcSet.from_iterable(op(LEFT, RIGHT))
+        assert op(left, right) == expected
+        assert getattr(left, method)(right, ProcSet.from_iterable(THIRD)) == \
+            ProcSet.from_iterable(op(op(LEFT, RIGHT), THIRD))
+
+        left = iop(left, right)
+        assert left == expected
+        # the operands are not pinned anymore
+        right |= ProcSet(8 * NB_ITV + 10)
+        assert (8 * NB_ITV + 10) in right
+
+    def test_comparisons(self):
+        left, right = ProcSet.from_iterable(LEFT), ProcSet.from_iterable(LEFT | RIGHT)
+        assert left == ProcSet.from_iterable(LEFT)
+        assert left == FrozenProcSet.from_iterable(LEFT)
+        assert left <= right
+        assert left < right
+        assert not right <= left
+        assert not left.isdisjoint(right)
+
+    def test_exported_target(self):
+        left, right = ProcSet.from_iterable(LEFT), ProcSet.from_iterable(RIGHT)
+        with memoryview(left):
+            with pytest.raises(BufferError):
+                left |= right
+        assert left == ProcSet.from_iterable(LEFT)
+
+    def test_modify_pinned_operand(self):
+        # the modifications wait for the sweeps reading the procset without the GIL
+        pool, other = ProcSet.from_iterable(LEFT), ProcSet.from_iterable(RIGHT)
+        points = [8 * NB_ITV + 10 + 2 * i for i in range(200)]
+        errors = []
+        done = threading.Event()
+
+        def read():
+            try:
+                while not done.is_set():
+                    pool & other  # pylint: disable=pointless-statement
+                    pool == other  # pylint: disable=pointless-statement
+            except Exception as error:  # pylint: disable=broad-except
+                errors.append(error)
+
+        def write(points):
+            try:
+                for point in points:
+                    pool.update(ProcSet(point))
+            except Exception as error:  # pylint: disable=broad-except
+                errors.append(error)
+
+        reader = threading.Thread(target=read)
+        writers = [threading.Thread(target=write, args=(points[i::2],)) for i in range(2)]
+        reader.start()
+        for writer in writers:
+            writer.start()
+        for writer in writers:
+            writer.join()
+        done.set()
+        reader.join()
+        assert not errors
+        # no modification overwrote another one
+        assert pool == ProcSet.from_iterable(LEFT | set(points))
+
+    @pytest.mark.parametrize('op, iop, method', OPERATORS)
+    def test_threads(self, op, iop, method):
+        left, right = FrozenProcSet.from_iterable(LEFT), FrozenProcSet.from_iterable(RIGHT)
+        expected = ProcSet.from_iterable(op(LEFT, RIGHT))
+        results = []
+
+        def work():
+            for _ in range(10):
+                results.append(op(left, right) == expected)
+
+        threads = [threading.Thread(target=work) for _ in range(4)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+        assert results == [True] * 40
+
+
+# enough intervals for a merge to be split in 4 partitions
+NB_ITV_PARALLEL = 150_000
+
+
+@functools.lru_cache(maxsize=None)
+def _random_pset(seed):
+    rng = random.Random(seed)
+    starts = rng.sample(range(0, 8 * NB_ITV_PARALLEL, 2), NB_ITV_PARALLEL)
+    # some intervals are long enough to go through the cuts between partitions
+    return ProcSet(*((start, start + rng.choice((0, 1, 3, 50))) for start in starts))
+
+
+@pytest.fixture
+def merge_threads():
+    previous = procset.set_merge_threads(4)
+    yield
+    procset.set_merge_threads(previous)
+
+
+class TestParallelMerge:
+    @pytest.mark.parametrize('op, iop, method', OPERATORS)
+    def test_operations(self, op, iop, method, merge_threads):  # pylint: disable=unused-argument,redefined-outer-name
+        left, right = _random_pset(1).copy(), _random_pset(2).copy()
+        procset.set_merge_threads(1)
+        expected = op(left, right)
+        expected_method = getattr(left, method)(right)
+        procset.set_merge_threads(4)
+
+        result = op(left, right)
+        assert result == expected
+        assert len(result) == len(expected)
+        assert getattr(left, method)(right) == expected_method
+        assert op(left, left) == op(left.copy(), left)
+
+    def test_set_merge_threads(self):
+        previous = procset.set_merge_threads(3)
+        assert procset.set_merge_threads(previous) == 3
+        for threads in (0, -1, 65):
+            with pytest.raises(ValueError):
+                procset.set_merge_threads(threads)
+
+    @pytest.mark.parametrize('op, iop, method', OPERATORS)
+    def test_settings_changed_during_merges(self, op, iop, method, merge_threads):  # pylint: disable=unused-argument,redefined-outer-name
+        left, right = _random_pset(1), _random_pset(3)
+        expected = op(left, right)
+        done = threading.Event()
+        results = []
+
+        # the merges read the settings once, with the GIL, and keep them while they run without it
+        def toggle():
+            while not done.is_set():
+                procset.set_merge_threads(random.choice((1, 2, 4)))
+                procset.set_gallop_ratio(random.choice((0, 2, 8)))
+
+        def work():
+            for _ in range(5):
+                results.append(op(left, right) == expected)
+
+        previous = procset.set_gallop_ratio(8)
+        toggler = threading.Thread(target=toggle)
+        workers = [threading.Thread(target=work) for _ in range(3)]
+        toggler.start()
+        for worker in workers:
+            worker.start()
+        for worker in workers:
+            worker.join()
+        done.set()
+        toggler.join()
+        procset.set_gallop_ratio(previous)
+        assert results == [True] * 15